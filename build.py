@@ -11,6 +11,7 @@ linker = "ld"
 java = "java"
 cc = "gcc"
 cc_supports_linking = True
+link_libraries = ["-lpthread", "-lm"] # threads for -generate, math for drawing
 
 drawapp = os.path.join(working_directory, "drawapp-4.0.jar")
 
@@ -95,7 +96,7 @@ def get_object_filename(path_to_c_file):
     return get_filename(path_to_c_file).replace(".c", ".o")
 
 def make_object(path_to_c_file):
-    return run_shell(cc, ["-o", f"{object_output}/{get_object_filename(path_to_c_file)}", "-c", path_to_c_file])
+    return run_shell(cc, ["-pthread", "-o", f"{object_output}/{get_object_filename(path_to_c_file)}", "-c", path_to_c_file])
 
 def link_files(object_dir, output_filename):
     object_files = [os.path.join(object_dir, f) for f in os.listdir(object_dir) if f.endswith('.o')]
@@ -106,9 +107,9 @@ def link_files(object_dir, output_filename):
 
     command = ""
     if cc_supports_linking:
-        command = [cc, "-o",  f"{binary_output}/{output_filename}"] + object_files
+        command = [cc, "-o",  f"{binary_output}/{output_filename}"] + object_files + link_libraries
     else:
-        command = [linker, "-o",  f"{binary_output}/{output_filename}"] + object_files
+        command = [linker, "-o",  f"{binary_output}/{output_filename}"] + object_files + link_libraries
 
     try:
         result = subprocess.run(command, check=True, capture_output=True, text=True)
@@ -2,9 +2,426 @@
 #include <stdlib.h>
 #include <string.h>
 
+#define CHUNK_SIDE (1 << ARENA_CHUNK_SHIFT)
+#define CHUNK_MASK (CHUNK_SIDE - 1)
+#define CHUNK_TILES (CHUNK_SIDE * CHUNK_SIDE)
+#define CHUNK_PLANES 3
+#define CHUNK_STORAGE (CHUNK_TILES + CHUNK_PLANES * CHUNK_SIDE * sizeof(uint64_t))
+
+void write_bit(uint64_t *plane, uint64_t word, uint64_t mask, int32_t value)
+{
+    if (value)
+    {
+        plane[word] |= mask;
+    }
+    else
+    {
+        plane[word] &= ~mask;
+    }
+}
+
+// Bits of one plane word for a tile type, indexed like the planes of a chunk: passable, markers, exists
+uint64_t plane_bits(uint8_t type, uint32_t plane)
+{
+    switch (plane)
+    {
+        case 0:
+            return is_walkable_tile(type) ? UINT64_MAX : 0;
+        case 1:
+            return type == 0x02 ? UINT64_MAX : 0;
+        default:
+            return type != 0xFF ? UINT64_MAX : 0;
+    }
+}
+
+void update_bitplanes(arena_t *arena, uint32_t x, uint32_t y, uint8_t type)
+{
+    uint64_t word = (uint64_t)y * arena->wordsPerRow + x / ARENA_WORD_BITS;
+    uint64_t mask = (uint64_t)1 << (x % ARENA_WORD_BITS);
+    write_bit(arena->passable, word, mask, is_walkable_tile(type));
+    write_bit(arena->markers, word, mask, type == 0x02);
+    write_bit(arena->exists, word, mask, type != 0xFF);
+}
+
+// Recomputes every bitplane from the grid
+void rebuild_bitplanes(arena_t *arena)
+{
+    uint64_t wordCount = (uint64_t)arena->wordsPerRow * arena->height;
+    memset(arena->passable, 0, wordCount * sizeof(uint64_t));
+    memset(arena->markers, 0, wordCount * sizeof(uint64_t));
+    memset(arena->exists, 0, wordCount * sizeof(uint64_t));
+    for (uint32_t y = 0; y < arena->height; y++)
+    {
+        for (uint32_t x = 0; x < arena->width; x++)
+        {
+            update_bitplanes(arena, x, y, arena->grid[arena_cell_index(arena, x, y)]);
+        }
+    }
+}
+
+// Tracked tile types get a counter in every chunk, anything else keeps its chunk allocated
+int32_t type_slot(uint8_t type)
+{
+    switch (type)
+    {
+        case 0x00:
+            return 0;
+        case 0x01:
+            return 1;
+        case 0x02:
+            return 2;
+        case 0xFF:
+            return 3;
+        default:
+            return -1;
+    }
+}
+
+uint64_t chunk_slot(arena_t *arena, uint64_t key)
+{
+    uint64_t hash = key * 0x9E3779B97F4A7C15ull;
+    return (hash ^ (hash >> 32)) & (arena->chunkCapacity - 1);
+}
+
+arena_chunk_t *find_chunk(arena_t *arena, uint64_t key)
+{
+    for (uint64_t slot = chunk_slot(arena, key);; slot = (slot + 1) & (arena->chunkCapacity - 1))
+    {
+        arena_chunk_t *chunk = &arena->chunks[slot];
+        if (chunk->key == key)
+        {
+            return chunk;
+        }
+        if (chunk->key == ARENA_NO_CHUNK)
+        {
+            return 0;
+        }
+    }
+}
+
+arena_chunk_t *allocate_chunk_table(uint64_t capacity)
+{
+    arena_chunk_t *chunks = malloc(capacity * sizeof(arena_chunk_t));
+    if (chunks)
+    {
+        memset(chunks, 0, capacity * sizeof(arena_chunk_t));
+        for (uint64_t i = 0; i < capacity; i++)
+        {
+            chunks[i].key = ARENA_NO_CHUNK;
+        }
+    }
+    return chunks;
+}
+
+// Chunks are never removed, a chunk that turns uniform again just drops its storage
+arena_chunk_t *insert_chunk(arena_t *arena, uint64_t key)
+{
+    if ((arena->chunkCount + 1) * 2 > arena->chunkCapacity)
+    {
+        arena_chunk_t *old = arena->chunks;
+        uint64_t oldCapacity = arena->chunkCapacity;
+        arena_chunk_t *chunks = allocate_chunk_table(oldCapacity * 2);
+        if (!chunks)
+        {
+            return 0;
+        }
+
+        arena->chunks = chunks;
+        arena->chunkCapacity = oldCapacity * 2;
+        for (uint64_t i = 0; i < oldCapacity; i++)
+        {
+            if (old[i].key != ARENA_NO_CHUNK)
+            {
+                uint64_t slot = chunk_slot(arena, old[i].key);
+                while (chunks[slot].key != ARENA_NO_CHUNK)
+                {
+                    slot = (slot + 1) & (arena->chunkCapacity - 1);
+                }
+                chunks[slot] = old[i];
+            }
+        }
+        free(old);
+    }
+
+    uint64_t slot = chunk_slot(arena, key);
+    while (arena->chunks[slot].key != ARENA_NO_CHUNK)
+    {
+        slot = (slot + 1) & (arena->chunkCapacity - 1);
+    }
+
+    arena_chunk_t *chunk = &arena->chunks[slot];
+    chunk->key = key;
+    chunk->uniform = 0x00;
+    arena->chunkCount++;
+    return chunk;
+}
+
+uint64_t chunk_key(arena_t *arena, uint32_t x, uint32_t y)
+{
+    return (uint64_t)(y >> ARENA_CHUNK_SHIFT) * arena->chunksPerRow + (x >> ARENA_CHUNK_SHIFT);
+}
+
+// Columns of chunkX that lie inside the arena, as a mask over one plane word
+uint64_t chunk_column_mask(arena_t *arena, uint32_t chunkX)
+{
+    uint32_t tail = arena->width % CHUNK_SIDE;
+    return chunkX + 1 == arena->chunksPerRow && tail ? ((uint64_t)1 << tail) - 1 : UINT64_MAX;
+}
+
+// Tiles of a chunk that lie inside the arena, a chunk is uniform once one type covers all of them
+uint32_t chunk_tile_count(arena_t *arena, uint64_t key)
+{
+    uint64_t chunkX = key % arena->chunksPerRow;
+    uint64_t chunkY = key / arena->chunksPerRow;
+    uint64_t columns = arena->width - chunkX * CHUNK_SIDE;
+    uint64_t rows = arena->height - chunkY * CHUNK_SIDE;
+    return (columns < CHUNK_SIDE ? columns : CHUNK_SIDE) * (rows < CHUNK_SIDE ? rows : CHUNK_SIDE);
+}
+
+uint64_t chunk_plane_word(arena_t *arena, arena_chunk_t *chunk, uint32_t chunkX, uint32_t plane, uint32_t row)
+{
+    if (chunk && chunk->tiles)
+    {
+        return chunk->planes[plane * CHUNK_SIDE + row];
+    }
+    return plane_bits(chunk ? chunk->uniform : 0x00, plane) & chunk_column_mask(arena, chunkX);
+}
+
+// Tiles, planes and the reference count of a chunk are one allocation
+int32_t allocate_chunk_storage(arena_chunk_t *chunk)
+{
+    uint8_t *storage = malloc(CHUNK_STORAGE + sizeof(atomic_uint));
+    if (!storage)
+    {
+        return 0;
+    }
+
+    chunk->tiles = storage;
+    chunk->planes = (uint64_t *)(storage + CHUNK_TILES);
+    chunk->references = (atomic_uint *)(storage + CHUNK_STORAGE);
+    atomic_init(chunk->references, 1);
+    return 1;
+}
+
+void release_chunk_storage(arena_chunk_t *chunk)
+{
+    if (chunk->tiles && atomic_fetch_sub(chunk->references, 1) == 1)
+    {
+        free(chunk->tiles);
+    }
+
+    chunk->tiles = 0;
+    chunk->planes = 0;
+    chunk->references = 0;
+}
+
+// Gives the chunk storage of its own before a write, when a snapshot still holds the current one
+int32_t unshare_chunk(arena_chunk_t *chunk)
+{
+    if (atomic_load(chunk->references) == 1)
+    {
+        return 1;
+    }
+
+    arena_chunk_t shared = *chunk;
+    if (!allocate_chunk_storage(chunk))
+    {
+        *chunk = shared;
+        return 0;
+    }
+
+    memcpy(chunk->tiles, shared.tiles, CHUNK_STORAGE);
+    release_chunk_storage(&shared);
+    return 1;
+}
+
+int32_t materialize_chunk(arena_t *arena, arena_chunk_t *chunk)
+{
+    if (!allocate_chunk_storage(chunk))
+    {
+        return 0;
+    }
+
+    memset(chunk->tiles, chunk->uniform, CHUNK_TILES);
+    uint32_t chunkX = chunk->key % arena->chunksPerRow;
+    for (uint32_t plane = 0; plane < CHUNK_PLANES; plane++)
+    {
+        uint64_t word = plane_bits(chunk->uniform, plane) & chunk_column_mask(arena, chunkX);
+        for (uint32_t row = 0; row < CHUNK_SIDE; row++)
+        {
+            chunk->planes[plane * CHUNK_SIDE + row] = word;
+        }
+    }
+
+    memset(chunk->typeCounts, 0, sizeof(chunk->typeCounts));
+    chunk->typeCounts[type_slot(chunk->uniform)] = chunk_tile_count(arena, chunk->key);
+    return 1;
+}
+
+uint8_t get_sparse_tile(arena_t *arena, uint32_t x, uint32_t y)
+{
+    arena_chunk_t *chunk = find_chunk(arena, chunk_key(arena, x, y));
+    if (!chunk)
+    {
+        return 0x00;
+    }
+    return chunk->tiles ? chunk->tiles[(y & CHUNK_MASK) * CHUNK_SIDE + (x & CHUNK_MASK)] : chunk->uniform;
+}
+
+// Returns 0 when the chunk storage could not be allocated and the tile is left unchanged
+int32_t set_sparse_tile(arena_t *arena, uint32_t x, uint32_t y, uint8_t type)
+{
+    uint64_t key = chunk_key(arena, x, y);
+    arena_chunk_t *chunk = find_chunk(arena, key);
+    if (!chunk)
+    {
+        if (type == 0x00)
+        {
+            return 1;
+        }
+
+        chunk = insert_chunk(arena, key);
+        if (!chunk)
+        {
+            return 0;
+        }
+    }
+
+    if (!chunk->tiles && (chunk->uniform == type || !materialize_chunk(arena, chunk)))
+    {
+        return chunk->uniform == type;
+    }
+
+    if (!unshare_chunk(chunk))
+    {
+        return 0;
+    }
+
+    uint8_t *tile = &chunk->tiles[(y & CHUNK_MASK) * CHUNK_SIDE + (x & CHUNK_MASK)];
+    int32_t oldSlot = type_slot(*tile);
+    int32_t newSlot = type_slot(type);
+    if (oldSlot >= 0)
+    {
+        chunk->typeCounts[oldSlot]--;
+    }
+    if (newSlot >= 0)
+    {
+        chunk->typeCounts[newSlot]++;
+    }
+
+    *tile = type;
+    uint64_t mask = (uint64_t)1 << (x & CHUNK_MASK);
+    for (uint32_t plane = 0; plane < CHUNK_PLANES; plane++)
+    {
+        write_bit(chunk->planes, plane * CHUNK_SIDE + (y & CHUNK_MASK), mask, plane_bits(type, plane) != 0);
+    }
+
+    if (newSlot >= 0 && chunk->typeCounts[newSlot] == chunk_tile_count(arena, key))
+    {
+        release_chunk_storage(chunk);
+        chunk->uniform = type;
+    }
+    return 1;
+}
+
+void record_change(arena_t *arena, uint32_t x, uint32_t y, uint8_t oldType, uint8_t newType)
+{
+    arena_change_t *change = &arena->journal[arena->journalEnd & (ARENA_JOURNAL_CAPACITY - 1)];
+    change->x = x;
+    change->y = y;
+    change->oldType = oldType;
+    change->newType = newType;
+    arena->journalEnd++;
+    if (arena->journalEnd - arena->journalStart > ARENA_JOURNAL_CAPACITY)
+    {
+        arena->journalStart = arena->journalEnd - ARENA_JOURNAL_CAPACITY;
+    }
+}
+
+// Width, height and the geometry derived from them in the arena's layout
+void set_arena_size(arena_t *arena, uint32_t width, uint32_t height)
+{
+    arena->width = width;
+    arena->height = height;
+    arena->blocksPerRow = ((uint64_t)width + (1 << ARENA_TILE_SHIFT) - 1) >> ARENA_TILE_SHIFT;
+    if (arena->layout == ARENA_LAYOUT_TILED)
+    {
+        uint64_t blockRows = ((uint64_t)height + (1 << ARENA_TILE_SHIFT) - 1) >> ARENA_TILE_SHIFT;
+        arena->cellCount = ((uint64_t)arena->blocksPerRow * blockRows) << (2 * ARENA_TILE_SHIFT);
+    }
+    else if (arena->layout == ARENA_LAYOUT_BORDERED)
+    {
+        arena->stride = (uint64_t)width + 2;
+        arena->cellCount = arena->stride * ((uint64_t)height + 2);
+    }
+    else
+    {
+        arena->stride = width;
+        arena->cellCount = (uint64_t)width * height;
+    }
+    arena->wordsPerRow = ((uint64_t)width + ARENA_WORD_BITS - 1) / ARENA_WORD_BITS;
+}
+
+// Replaces the grid and bitplanes of a dense arena with storage for its current size, on failure they are all 0
+int32_t allocate_dense_storage(arena_t *arena)
+{
+    free(arena->grid);
+    free(arena->passable);
+    free(arena->markers);
+    free(arena->exists);
+    arena->grid = 0;
+    arena->passable = 0;
+    arena->markers = 0;
+    arena->exists = 0;
+    arena->gridCapacity = 0;
+    arena->planeCapacity = 0;
+
+    uint64_t wordCount = (uint64_t)arena->wordsPerRow * arena->height;
+    if (arena->cellCount > SIZE_MAX / sizeof(uint64_t))
+    {
+        return 0;
+    }
+
+    arena->grid = malloc(arena->cellCount);
+    arena->passable = malloc(wordCount * sizeof(uint64_t));
+    arena->markers = malloc(wordCount * sizeof(uint64_t));
+    arena->exists = malloc(wordCount * sizeof(uint64_t));
+    if (!arena->grid || !arena->passable || !arena->markers || !arena->exists)
+    {
+        return 0;
+    }
+
+    arena->gridCapacity = arena->cellCount;
+    arena->planeCapacity = wordCount;
+    return 1;
+}
+
+// Sets every tile of a dense arena to empty, with the sentinel ring around bordered arenas
+void clear_dense_grid(arena_t *arena)
+{
+    memset(arena->grid, 0, arena->cellCount);
+    if (arena->layout == ARENA_LAYOUT_BORDERED)
+    {
+        memset(arena->grid, 0xFF, arena->stride);
+        memset(&arena->grid[arena->cellCount - arena->stride], 0xFF, arena->stride);
+        for (uint64_t row = 1; row <= arena->height; row++)
+        {
+            arena->grid[row * arena->stride] = 0xFF;
+            arena->grid[row * arena->stride + arena->width + 1] = 0xFF;
+        }
+    }
+
+    rebuild_bitplanes(arena);
+}
+
 arena_t *create_arena(uint32_t width, uint32_t height)
 {
-    if (width == 0 || height == 0)
+    return create_arena_with_layout(width, height, ARENA_LAYOUT_ROW_MAJOR);
+}
+
+arena_t *create_arena_with_layout(uint32_t width, uint32_t height, arena_layout_t layout)
+{
+    if (width == 0 || height == 0 || layout > ARENA_LAYOUT_BORDERED)
     {
         return 0;
     }
@@ -15,36 +432,214 @@ arena_t *create_arena(uint32_t width, uint32_t height)
         return 0;
     }
 
-    arena->width = width;
-    arena->height = height;
+    memset(arena, 0, sizeof(arena_t));
+    arena->version = 0;
+    arena->layout = layout;
+    set_arena_size(arena, width, height);
+    arena->journal = malloc(ARENA_JOURNAL_CAPACITY * sizeof(arena_change_t));
 
-    arena->grid = calloc(width * height, sizeof(uint8_t));
-    if (!arena->grid)
+    if (layout == ARENA_LAYOUT_SPARSE)
     {
-        free(arena);
+        arena->chunksPerRow = arena->wordsPerRow;
+        arena->chunkCapacity = 64;
+        arena->chunks = allocate_chunk_table(arena->chunkCapacity);
+        arena->rowScratch = malloc(arena->wordsPerRow * sizeof(uint64_t));
+        if (!arena->chunks || !arena->rowScratch || !arena->journal)
+        {
+            dispose_arena(arena);
+            return 0;
+        }
+        return arena;
+    }
+
+    if (!arena->journal || !allocate_dense_storage(arena))
+    {
+        dispose_arena(arena);
         return 0;
     }
 
+    clear_dense_grid(arena);
     return arena;
 }
 
+// Resizes an arena to width x height empty tiles. Dense layouts keep their grid and bitplanes when the new size fits
+// into them, so one arena can be reused for many arenas of similar size. Sparse arenas are never reset, their callers
+// create a new arena instead. Like set_grid the whole arena changes at once, which starts a new journal. Returns 0 if
+// the arena could not be resized, an arena whose storage could not be grown is only fit for dispose_arena.
+int32_t reset_arena(arena_t *arena, uint32_t width, uint32_t height)
+{
+    if (!validate_arena(arena) || arena->layout == ARENA_LAYOUT_SPARSE || width == 0 || height == 0)
+    {
+        return 0;
+    }
+
+    set_arena_size(arena, width, height);
+    if ((arena->cellCount > arena->gridCapacity || (uint64_t)arena->wordsPerRow * height > arena->planeCapacity) && !allocate_dense_storage(arena))
+    {
+        return 0;
+    }
+
+    arena->version++;
+    arena->journalEnd++;
+    arena->journalStart = arena->journalEnd;
+    clear_dense_grid(arena);
+    return 1;
+}
+
+// Returns an independent arena with the current tiles, later writes to either one do not show up in the other.
+// Sparse snapshots copy the chunk table and share the chunk storage, so they cost O(chunks) and only a written chunk
+// is ever copied. The other layouts have one flat grid and copy it together with the bitplanes. Snapshots have to be
+// taken on the thread writing the arena, but can then be read and disposed of on any other thread.
+arena_t *create_arena_snapshot(arena_t *arena)
+{
+    if (!validate_arena(arena))
+    {
+        return 0;
+    }
+
+    arena_t *snapshot = malloc(sizeof(arena_t));
+    if (!snapshot)
+    {
+        return 0;
+    }
+
+    *snapshot = *arena;
+    snapshot->journal = malloc(ARENA_JOURNAL_CAPACITY * sizeof(arena_change_t));
+    if (arena->layout == ARENA_LAYOUT_SPARSE)
+    {
+        snapshot->chunks = malloc(arena->chunkCapacity * sizeof(arena_chunk_t));
+        snapshot->rowScratch = malloc(arena->wordsPerRow * sizeof(uint64_t));
+        if (!snapshot->chunks || !snapshot->rowScratch || !snapshot->journal)
+        {
+            free(snapshot->chunks);
+            free(snapshot->rowScratch);
+            free(snapshot->journal);
+            free(snapshot);
+            return 0;
+        }
+
+        memcpy(snapshot->journal, arena->journal, ARENA_JOURNAL_CAPACITY * sizeof(arena_change_t));
+
+        memcpy(snapshot->chunks, arena->chunks, arena->chunkCapacity * sizeof(arena_chunk_t));
+        for (uint64_t i = 0; i < arena->chunkCapacity; i++)
+        {
+            if (arena->chunks[i].tiles)
+            {
+                atomic_fetch_add(arena->chunks[i].references, 1);
+            }
+        }
+        return snapshot;
+    }
+
+    uint64_t wordCount = (uint64_t)arena->wordsPerRow * arena->height;
+    snapshot->gridCapacity = arena->cellCount;
+    snapshot->planeCapacity = wordCount;
+    snapshot->grid = malloc(arena->cellCount);
+    snapshot->passable = malloc(wordCount * sizeof(uint64_t));
+    snapshot->markers = malloc(wordCount * sizeof(uint64_t));
+    snapshot->exists = malloc(wordCount * sizeof(uint64_t));
+    if (!validate_arena(snapshot))
+    {
+        dispose_arena(snapshot);
+        return 0;
+    }
+
+    memcpy(snapshot->journal, arena->journal, ARENA_JOURNAL_CAPACITY * sizeof(arena_change_t));
+    memcpy(snapshot->grid, arena->grid, arena->cellCount);
+    memcpy(snapshot->passable, arena->passable, wordCount * sizeof(uint64_t));
+    memcpy(snapshot->markers, arena->markers, wordCount * sizeof(uint64_t));
+    memcpy(snapshot->exists, arena->exists, wordCount * sizeof(uint64_t));
+    return snapshot;
+}
+
 void dispose_arena(arena_t *arena)
 {
     if (arena)
     {
+        for (uint64_t i = 0; arena->chunks && i < arena->chunkCapacity; i++)
+        {
+            release_chunk_storage(&arena->chunks[i]);
+        }
+        free(arena->chunks);
+        free(arena->rowScratch);
+        free(arena->journal);
         free(arena->grid);
+        free(arena->passable);
+        free(arena->markers);
+        free(arena->exists);
         free(arena);
     }
 }
 
 int validate_arena(arena_t *arena)
 {
-    if (!arena || !arena->grid || arena->width == 0 || arena->height == 0)
+    if (!arena || arena->width == 0 || arena->height == 0)
     {
         return 0;
     }
 
-    return 1;
+    if (arena->layout == ARENA_LAYOUT_SPARSE)
+    {
+        return arena->chunks && arena->rowScratch && arena->journal;
+    }
+
+    return arena->grid && arena->passable && arena->markers && arena->exists && arena->journal;
+}
+
+// No bounds checks, callers pass coordinates inside the arena and cells below cellCount
+uint64_t arena_cell_index(arena_t *arena, uint32_t x, uint32_t y)
+{
+    if (arena->layout == ARENA_LAYOUT_BORDERED)
+    {
+        return ((uint64_t)y + 1) * arena->stride + x + 1;
+    }
+
+    if (arena->layout != ARENA_LAYOUT_TILED)
+    {
+        return (uint64_t)y * arena->width + x;
+    }
+
+    uint32_t mask = (1 << ARENA_TILE_SHIFT) - 1;
+    uint64_t block = (uint64_t)(y >> ARENA_TILE_SHIFT) * arena->blocksPerRow + (x >> ARENA_TILE_SHIFT);
+    return (block << (2 * ARENA_TILE_SHIFT)) | ((y & mask) << ARENA_TILE_SHIFT) | (x & mask);
+}
+
+uint32_t arena_cell_x(arena_t *arena, uint64_t cell)
+{
+    if (arena->layout == ARENA_LAYOUT_BORDERED)
+    {
+        return cell % arena->stride - 1;
+    }
+
+    if (arena->layout != ARENA_LAYOUT_TILED)
+    {
+        return cell % arena->width;
+    }
+
+    uint32_t mask = (1 << ARENA_TILE_SHIFT) - 1;
+    return (((cell >> (2 * ARENA_TILE_SHIFT)) % arena->blocksPerRow) << ARENA_TILE_SHIFT) | (cell & mask);
+}
+
+uint32_t arena_cell_y(arena_t *arena, uint64_t cell)
+{
+    if (arena->layout == ARENA_LAYOUT_BORDERED)
+    {
+        return cell / arena->stride - 1;
+    }
+
+    if (arena->layout != ARENA_LAYOUT_TILED)
+    {
+        return cell / arena->width;
+    }
+
+    uint32_t mask = (1 << ARENA_TILE_SHIFT) - 1;
+    return (((cell >> (2 * ARENA_TILE_SHIFT)) / arena->blocksPerRow) << ARENA_TILE_SHIFT) | ((cell >> ARENA_TILE_SHIFT) & mask);
+}
+
+// Empty and marker tiles can be walked on, obstacles and nonexistent tiles cannot
+int32_t is_walkable_tile(uint8_t type)
+{
+    return type == 0x00 || type == 0x02;
 }
 
 uint8_t get_tile(arena_t *arena, uint32_t x, uint32_t y)
@@ -54,7 +649,12 @@ uint8_t get_tile(arena_t *arena, uint32_t x, uint32_t y)
         return 0xFF;
     }
 
-    return arena->grid[y * arena->width + x];
+    if (arena->layout == ARENA_LAYOUT_SPARSE)
+    {
+        return get_sparse_tile(arena, x, y);
+    }
+
+    return arena->grid[arena_cell_index(arena, x, y)];
 }
 
 void set_tile(arena_t *arena, uint32_t x, uint32_t y, uint8_t type)
@@ -63,8 +663,37 @@ void set_tile(arena_t *arena, uint32_t x, uint32_t y, uint8_t type)
     {
         return;
     }
-    
-    arena->grid[y * arena->width + x] = type;
+
+    if (arena->layout == ARENA_LAYOUT_SPARSE)
+    {
+        uint8_t old = get_sparse_tile(arena, x, y);
+        if (old == type || !set_sparse_tile(arena, x, y, type))
+        {
+            return;
+        }
+
+        record_change(arena, x, y, old, type);
+        if (is_walkable_tile(old) != is_walkable_tile(type))
+        {
+            arena->version++;
+        }
+        return;
+    }
+
+    uint8_t *tile = &arena->grid[arena_cell_index(arena, x, y)];
+    if (*tile == type)
+    {
+        return;
+    }
+
+    record_change(arena, x, y, *tile, type);
+    if (is_walkable_tile(*tile) != is_walkable_tile(type))
+    {
+        arena->version++;
+    }
+
+    *tile = type;
+    update_bitplanes(arena, x, y, type);
 }
 
 void set_empty_tile(arena_t *arena, uint32_t x, uint32_t y)
@@ -87,10 +716,105 @@ void delete_tile(arena_t *arena, uint32_t x, uint32_t y)
     set_tile(arena, x, y, 0xFF);
 }
 
+// The grid has to hold cellCount tiles in the arena's layout, sparse arenas have no flat grid to replace
 void set_grid(arena_t *arena, uint8_t *grid)
 {
-    if (arena)
+    if (arena && arena->layout != ARENA_LAYOUT_SPARSE)
     {
+        // the whole grid changes at once, which no journal range can describe
         arena->grid = grid;
+        arena->version++;
+        arena->journalEnd++;
+        arena->journalStart = arena->journalEnd;
+        if (validate_arena(arena))
+        {
+            rebuild_bitplanes(arena);
+        }
+    }
+}
+
+const uint64_t *dense_plane(arena_t *arena, uint32_t plane)
+{
+    return plane == 0 ? arena->passable : plane == 1 ? arena->markers : arena->exists;
+}
+
+int32_t test_bit(arena_t *arena, uint32_t plane, uint32_t x, uint32_t y)
+{
+    if (!validate_arena(arena) || x >= arena->width || y >= arena->height)
+    {
+        return 0;
+    }
+
+    if (arena->layout == ARENA_LAYOUT_SPARSE)
+    {
+        arena_chunk_t *chunk = find_chunk(arena, chunk_key(arena, x, y));
+        return (chunk_plane_word(arena, chunk, x >> ARENA_CHUNK_SHIFT, plane, y & CHUNK_MASK) >> (x & CHUNK_MASK)) & 1;
     }
+
+    return (dense_plane(arena, plane)[(uint64_t)y * arena->wordsPerRow + x / ARENA_WORD_BITS] >> (x % ARENA_WORD_BITS)) & 1;
+}
+
+int32_t arena_is_passable(arena_t *arena, uint32_t x, uint32_t y)
+{
+    return test_bit(arena, 0, x, y);
+}
+
+int32_t arena_is_marker(arena_t *arena, uint32_t x, uint32_t y)
+{
+    return test_bit(arena, 1, x, y);
+}
+
+// Sparse rows are put together one chunk word at a time in rowScratch
+const uint64_t *plane_row(arena_t *arena, uint32_t plane, uint32_t y)
+{
+    if (!validate_arena(arena) || y >= arena->height)
+    {
+        return 0;
+    }
+
+    if (arena->layout != ARENA_LAYOUT_SPARSE)
+    {
+        return &dense_plane(arena, plane)[(uint64_t)y * arena->wordsPerRow];
+    }
+
+    for (uint32_t chunkX = 0; chunkX < arena->chunksPerRow; chunkX++)
+    {
+        arena_chunk_t *chunk = find_chunk(arena, chunk_key(arena, chunkX << ARENA_CHUNK_SHIFT, y));
+        arena->rowScratch[chunkX] = chunk_plane_word(arena, chunk, chunkX, plane, y & CHUNK_MASK);
+    }
+    return arena->rowScratch;
+}
+
+// Row accessors for word at a time kernels, each row is wordsPerRow words long. Rows of a sparse arena share one
+// buffer, so a row is only valid until the next call.
+const uint64_t *arena_passable_row(arena_t *arena, uint32_t y)
+{
+    return plane_row(arena, 0, y);
+}
+
+const uint64_t *arena_marker_row(arena_t *arena, uint32_t y)
+{
+    return plane_row(arena, 1, y);
+}
+
+const uint64_t *arena_exists_row(arena_t *arena, uint32_t y)
+{
+    return plane_row(arena, 2, y);
+}
+
+// Whether every change from sequence on is still in the journal, otherwise a consumer has to rebuild from the tiles
+int32_t arena_journal_covers(arena_t *arena, uint64_t sequence)
+{
+    return arena && arena->journal && sequence >= arena->journalStart && sequence <= arena->journalEnd;
+}
+
+// Returns 0 for sequences that fell out of the journal or were not handed out yet
+const arena_change_t *arena_change_at(arena_t *arena, uint64_t sequence)
+{
+    if (!arena_journal_covers(arena, sequence) || sequence == arena->journalEnd)
+    {
+        return 0;
+    }
+
+    return &arena->journal[sequence & (ARENA_JOURNAL_CAPACITY - 1)];
 }
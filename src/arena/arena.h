@@ -2,17 +2,90 @@
 #define __ARENA_H__
 
 #include <stdint.h>
+#include <stdatomic.h>
 
+#define ARENA_WORD_BITS 64
+#define ARENA_TILE_SHIFT 3 // tiled layouts store 8x8 blocks of tiles next to each other
+#define ARENA_CHUNK_SHIFT 6 // sparse layouts store 64x64 chunks, every chunk row is one bitplane word
+#define ARENA_NO_CHUNK UINT64_MAX
+#define ARENA_JOURNAL_CAPACITY 1024 // power of two
+
+typedef enum {
+    ARENA_LAYOUT_ROW_MAJOR,
+    ARENA_LAYOUT_TILED,
+    ARENA_LAYOUT_SPARSE,
+    ARENA_LAYOUT_BORDERED
+} arena_layout_t;
+
+// One chunk of a sparse arena. While every tile has the same type only that type is kept, tiles and planes are
+// allocated on the first write that breaks the pattern and released again once the chunk is uniform.
+// Snapshots share the storage of their chunks, a write to a chunk whose storage is shared copies it first.
+typedef struct {
+    uint64_t key; // chunkY * chunksPerRow + chunkX, ARENA_NO_CHUNK marks a free slot
+    uint8_t uniform; // type of every tile while tiles is 0
+    uint8_t *tiles;
+    uint64_t *planes; // passable, markers and exists rows of the chunk, allocated together with tiles
+    atomic_uint *references; // arenas sharing tiles, kept at the end of the same allocation
+    uint16_t typeCounts[4]; // empty, obstacle, marker and nonexistent tiles
+} arena_chunk_t;
+
+// One entry of the change journal, tiles set to the type they already had are not recorded
+typedef struct {
+    uint32_t x;
+    uint32_t y;
+    uint8_t oldType;
+    uint8_t newType;
+} arena_change_t;
+
+// Tiles are stored at arena_cell_index(x, y), row after row or tile block after tile block depending on the layout.
+// Searches index their own per-cell buffers the same way, so vertical neighbours stay close on wide arenas.
+// Besides one byte per tile the arena keeps three bitplanes in sync with the grid, one bit per tile and
+// wordsPerRow 64-bit words per row. Bit x % 64 of word x / 64 belongs to column x, bits past the width stay 0.
+// Bordered arenas are row-major with a ring of nonexistent sentinel tiles around them, so every neighbour of an
+// arena cell is a valid index that is simply never walkable.
+// Sparse arenas have neither a grid nor flat planes, their chunks live in an open addressing table and chunks that
+// were never written are empty. Their cell indices are row-major and only meant for per-cell search buffers.
 typedef struct {
     uint32_t width;
     uint32_t height;
+    arena_layout_t layout;
+    uint32_t blocksPerRow; // 8x8 blocks per block row in the tiled layout
+    uint64_t stride; // grid cells from one row to the next in the row-major and bordered layouts
+    uint64_t cellCount; // storage cells, the tiled layout pads the last block row and column
     uint8_t *grid;
+    uint64_t gridCapacity; // cells the grid has room for, reset_arena only reallocates when a larger arena needs more
+    uint32_t version; // bumped whenever a tile changes between walkable and blocked, cached paths compare against it
+    uint32_t wordsPerRow;
+    uint64_t *passable; // empty or marker
+    uint64_t *markers;
+    uint64_t *exists; // anything but nonexistent
+    uint64_t planeCapacity; // words every bitplane has room for
+
+    uint32_t chunksPerRow;
+    arena_chunk_t *chunks;
+    uint64_t chunkCapacity; // power of two
+    uint64_t chunkCount;
+    uint64_t *rowScratch; // sparse rows are gathered here, valid until the next row accessor call
+
+    // Every tile change gets the next sequence number and is kept in a ring of the last ARENA_JOURNAL_CAPACITY
+    // changes. Consumers remember the sequence they have seen up to and rebuild once that fell out of the ring.
+    arena_change_t *journal;
+    uint64_t journalStart; // oldest sequence still in the journal
+    uint64_t journalEnd; // sequence of the next change
 } arena_t;
 
 arena_t *create_arena(uint32_t width, uint32_t height);
+arena_t *create_arena_with_layout(uint32_t width, uint32_t height, arena_layout_t layout);
+arena_t *create_arena_snapshot(arena_t *arena);
 void dispose_arena(arena_t *arena);
+int32_t reset_arena(arena_t *arena, uint32_t width, uint32_t height);
 int validate_arena(arena_t *arena);
 
+uint64_t arena_cell_index(arena_t *arena, uint32_t x, uint32_t y);
+uint32_t arena_cell_x(arena_t *arena, uint64_t cell);
+uint32_t arena_cell_y(arena_t *arena, uint64_t cell);
+
+int32_t is_walkable_tile(uint8_t type);
 uint8_t get_tile(arena_t *arena, uint32_t x, uint32_t y);
 void set_tile(arena_t *arena, uint32_t x, uint32_t y, uint8_t type);
 void set_empty_tile(arena_t *arena, uint32_t x, uint32_t y);
@@ -21,4 +94,38 @@ void set_marker_tile(arena_t *arena, uint32_t x, uint32_t y);
 void delete_tile(arena_t *arena, uint32_t x, uint32_t y);
 void set_grid(arena_t *arena, uint8_t *grid);
 
+// Unchecked accessors for hot loops over dense layouts, cell has to come from arena_cell_index. On a bordered arena
+// cell + arena_neighbor_offset and arena_bordered_index for coordinates from -1 to width or height are fine too.
+static inline uint8_t arena_tile_at(const arena_t *arena, uint64_t cell)
+{
+    return arena->grid[cell];
+}
+
+static inline int32_t arena_walkable_at(const arena_t *arena, uint64_t cell)
+{
+    uint8_t type = arena->grid[cell];
+    return type == 0x00 || type == 0x02;
+}
+
+static inline uint64_t arena_bordered_index(const arena_t *arena, int32_t x, int32_t y)
+{
+    return (uint64_t)((int64_t)(y + 1) * (int64_t)arena->stride + x + 1);
+}
+
+// Directions follow the robot: 0 north, 1 east, 2 south, 3 west
+static inline int64_t arena_neighbor_offset(const arena_t *arena, uint32_t direction)
+{
+    int64_t stride = arena->stride;
+    return direction == 0 ? -stride : direction == 1 ? 1 : direction == 2 ? stride : -1;
+}
+
+int32_t arena_is_passable(arena_t *arena, uint32_t x, uint32_t y);
+int32_t arena_is_marker(arena_t *arena, uint32_t x, uint32_t y);
+const uint64_t *arena_passable_row(arena_t *arena, uint32_t y);
+const uint64_t *arena_marker_row(arena_t *arena, uint32_t y);
+const uint64_t *arena_exists_row(arena_t *arena, uint32_t y);
+
+int32_t arena_journal_covers(arena_t *arena, uint64_t sequence);
+const arena_change_t *arena_change_at(arena_t *arena, uint64_t sequence);
+
 #endif
@@ -0,0 +1,131 @@
+#include "./batch.h"
+#include "../defaults.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+maze_batch_t *create_maze_batch(const char *directory, uint32_t mazeCount, uint32_t threadCount, uint64_t seed, generator_type_t generator)
+{
+    if (!directory || !threadCount)
+    {
+        return 0;
+    }
+
+    maze_batch_t *batch = malloc(sizeof(maze_batch_t));
+    if (!batch)
+    {
+        return 0;
+    }
+
+    memset(batch, 0, sizeof(maze_batch_t));
+    if (pthread_mutex_init(&batch->lock, 0) != 0)
+    {
+        free(batch);
+        return 0;
+    }
+
+    batch->directory = directory;
+    batch->mazeCount = mazeCount;
+    batch->threadCount = threadCount;
+    batch->generator = generator;
+    prng_seed(&batch->streams, seed);
+    return batch;
+}
+
+void dispose_maze_batch(maze_batch_t *batch)
+{
+    if (batch)
+    {
+        pthread_mutex_destroy(&batch->lock);
+        free(batch);
+    }
+}
+
+int32_t write_batch_maze(maze_batch_t *batch, maze_workspace_t *workspace, prng_t *prng, uint32_t job, char *path, size_t pathSize)
+{
+    maze_settings_t settings = generate_random_maze_in(workspace, prng, batch->generator, MIN_WIDTH, MAX_WIDTH, MIN_HEIGHT, MAX_HEIGHT, PADDING_SIZE, BACKGROUND_COLOR, PIXEL_PER_SIDE, MAX_OBSTACLE_AREA_PERCENTAGE, MAX_MARKER_AREA_PERCENTAGE, ROBOT_BORDER_COLOR, ROBOT_FILL_COLOR);
+    snprintf(path, pathSize, "%s/maze-%u.txt", batch->directory, job);
+    FILE *file = validate_maze_settings(settings) ? fopen(path, "w") : 0;
+    int32_t written = file && write_maze_settings(file, &settings);
+    if (file && fclose(file) != 0)
+    {
+        written = 0;
+    }
+
+    free_maze_settings(&settings);
+    return written;
+}
+
+void *run_batch_worker(void *argument)
+{
+    maze_batch_t *batch = argument;
+    maze_workspace_t *workspace = create_maze_workspace();
+    size_t pathSize = strlen(batch->directory) + 32;
+    char *path = malloc(pathSize);
+
+    while (1)
+    {
+        pthread_mutex_lock(&batch->lock);
+        if (batch->nextJob >= batch->mazeCount)
+        {
+            pthread_mutex_unlock(&batch->lock);
+            break;
+        }
+
+        // taking the job and its stream under one lock keeps stream n with job n
+        uint32_t job = batch->nextJob++;
+        prng_t prng = prng_split(&batch->streams);
+        pthread_mutex_unlock(&batch->lock);
+
+        int32_t written = workspace && path && write_batch_maze(batch, workspace, &prng, job, path, pathSize);
+
+        pthread_mutex_lock(&batch->lock);
+        batch->written += written;
+        batch->failed += !written;
+        pthread_mutex_unlock(&batch->lock);
+    }
+
+    free(path);
+    dispose_maze_workspace(workspace);
+    return 0;
+}
+
+double batch_wall_seconds(void)
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Runs every job and returns 1 if all of them were written. Fewer threads are used when not all of them can be
+// started, and the calling thread works through the jobs itself when none can.
+int32_t run_maze_batch(maze_batch_t *batch)
+{
+    if (!batch)
+    {
+        return 0;
+    }
+
+    pthread_t *threads = malloc(batch->threadCount * sizeof(pthread_t));
+    uint32_t started = 0;
+    double start = batch_wall_seconds();
+    while (threads && started < batch->threadCount && pthread_create(&threads[started], 0, run_batch_worker, batch) == 0)
+    {
+        started++;
+    }
+
+    if (!started)
+    {
+        run_batch_worker(batch);
+    }
+
+    for (uint32_t i = 0; i < started; i++)
+    {
+        pthread_join(threads[i], 0);
+    }
+
+    batch->seconds = batch_wall_seconds() - start;
+    free(threads);
+    return batch->written == batch->mazeCount;
+}
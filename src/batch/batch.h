@@ -0,0 +1,28 @@
+#ifndef __BATCH_H__
+#define __BATCH_H__
+
+#include "../maze/maze.h"
+#include <pthread.h>
+
+// Generates mazeCount random mazes into directory/maze-<job>.txt on a pool of threads that take jobs in order. Job n
+// always draws from the n-th stream split off the seed, so the files only depend on the seed and never on which
+// thread ran a job. Every thread keeps one maze workspace for all of its jobs.
+typedef struct {
+    const char *directory;
+    uint32_t mazeCount;
+    uint32_t threadCount;
+    generator_type_t generator;
+
+    pthread_mutex_t lock; // guards everything below
+    uint32_t nextJob;
+    prng_t streams; // the next job's stream is split off here
+    uint32_t written;
+    uint32_t failed;
+    double seconds; // wall time run_maze_batch took
+} maze_batch_t;
+
+maze_batch_t *create_maze_batch(const char *directory, uint32_t mazeCount, uint32_t threadCount, uint64_t seed, generator_type_t generator);
+void dispose_maze_batch(maze_batch_t *batch);
+int32_t run_maze_batch(maze_batch_t *batch);
+
+#endif
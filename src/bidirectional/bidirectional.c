@@ -0,0 +1,140 @@
+#include "./bidirectional.h"
+#include <stdlib.h>
+
+// Bidirectional A* with the stopping rule from Pohl, "Bi-directional search": once either open list has no
+// f below the best meeting cost found so far, no shorter path can exist.
+
+#define BIDIRECTIONAL_NO_MEETING UINT32_MAX
+
+static const int32_t neighborX[4] = {0, 1, 0, -1};
+static const int32_t neighborY[4] = {-1, 0, 1, 0};
+
+// Returns 0 when the open list ran out of memory
+int32_t seed_search(pathfinder_t *search, uint32_t x, uint32_t y, uint32_t targetX, uint32_t targetY)
+{
+    uint32_t cell = arena_cell_index(search->arena, x, y);
+    pf_begin_query(search);
+    search->stamp[cell] = search->generation;
+    search->g[cell] = 0;
+    search->parent[cell] = PF_NO_PARENT;
+    search->outOfMemory = !pq_push(search->openList, cell, heuristic(x, y, targetX, targetY), 0);
+    return !search->outOfMemory;
+}
+
+// Expands the best cell of one side and records every cell both sides have reached as a candidate meeting point
+void expand_side(pathfinder_t *search, pathfinder_t *other, uint32_t targetX, uint32_t targetY, uint32_t *bestCost, uint32_t *meeting)
+{
+    uint32_t current = pq_pop(search->openList);
+    search->heapSlot[current] = PF_CLOSED;
+    search->stats.heapOperations++;
+    search->stats.expandedNodes++;
+
+    int32_t x = arena_cell_x(search->arena, current);
+    int32_t y = arena_cell_y(search->arena, current);
+    for (int32_t i = 0; i < 4; i++)
+    {
+        int32_t nx = x + neighborX[i];
+        int32_t ny = y + neighborY[i];
+        if (!process_neighbor(search, current, nx, ny, targetX, targetY))
+        {
+            return;
+        }
+
+        uint32_t cell = arena_cell_index(search->arena, nx, ny);
+        if (!pf_is_walkable(search, nx, ny) || !pf_is_visited(search, cell) || !pf_is_visited(other, cell))
+        {
+            continue;
+        }
+
+        uint32_t cost = search->g[cell] + other->g[cell];
+        if (cost < *bestCost)
+        {
+            *bestCost = cost;
+            *meeting = cell;
+        }
+    }
+}
+
+node_t *bidirectional_search(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint32_t goalX, uint32_t goalY)
+{
+    if (!pathfinder || startX >= pathfinder->width || startY >= pathfinder->height || goalX >= pathfinder->width || goalY >= pathfinder->height)
+    {
+        return 0;
+    }
+
+    if (!pathfinder->reverse)
+    {
+        pathfinder->reverse = create_pathfinder(pathfinder->arena);
+        if (!pathfinder->reverse || !pf_set_queue_type(pathfinder->reverse, pathfinder->openList->type))
+        {
+            dispose_pathfinder(pathfinder->reverse);
+            pathfinder->reverse = 0;
+            return 0;
+        }
+    }
+
+    pathfinder_t *forward = pathfinder;
+    pathfinder_t *backward = pathfinder->reverse;
+    int32_t seeded = seed_search(forward, startX, startY, goalX, goalY) && seed_search(backward, goalX, goalY, startX, startY);
+    forward->stats.heapOperations += 2;
+
+    uint32_t startCell = arena_cell_index(pathfinder->arena, startX, startY);
+    uint32_t goalCell = arena_cell_index(pathfinder->arena, goalX, goalY);
+    uint32_t bestCost = startCell == goalCell ? 0 : BIDIRECTIONAL_NO_MEETING;
+    uint32_t meeting = startCell;
+
+    // a side that ran out of memory has lost cells, the other one alone cannot prove the best meeting point
+    while (seeded && !pq_is_empty(forward->openList) && !pq_is_empty(backward->openList) && !forward->outOfMemory && !backward->outOfMemory)
+    {
+        uint32_t forwardMin = pq_min_f(forward->openList);
+        uint32_t backwardMin = pq_min_f(backward->openList);
+        if (bestCost != BIDIRECTIONAL_NO_MEETING && (forwardMin >= bestCost || backwardMin >= bestCost))
+        {
+            break;
+        }
+
+        // grow the side with the smaller frontier, it is usually the cheaper one to expand
+        if (forward->openList->size <= backward->openList->size)
+        {
+            expand_side(forward, backward, goalX, goalY, &bestCost, &meeting);
+        }
+        else
+        {
+            expand_side(backward, forward, startX, startY, &bestCost, &meeting);
+        }
+    }
+
+    pathfinder->stats.expandedNodes += backward->stats.expandedNodes;
+    pathfinder->stats.heapOperations += backward->stats.heapOperations;
+    backward->stats = (pathfinder_stats_t){0};
+    pathfinder->outOfMemory |= backward->outOfMemory;
+
+    if (bestCost == BIDIRECTIONAL_NO_MEETING || pathfinder->outOfMemory)
+    {
+        return 0;
+    }
+
+    // start to meeting point from the forward parents, then meeting point to goal from the backward ones
+    uint32_t *cells = malloc((bestCost + 1) * sizeof(uint32_t));
+    if (!cells)
+    {
+        return 0;
+    }
+
+    uint32_t cell = meeting;
+    for (int32_t i = forward->g[meeting]; i >= 0; i--)
+    {
+        cells[i] = cell;
+        cell = forward->parent[cell];
+    }
+
+    uint32_t count = forward->g[meeting] + 1;
+    for (cell = backward->parent[meeting]; cell != PF_NO_PARENT && count <= bestCost; cell = backward->parent[cell])
+    {
+        cells[count++] = cell;
+    }
+
+    node_t *path = pf_build_path_from_cells(pathfinder, cells, count, goalX, goalY);
+    free(cells);
+    return path;
+}
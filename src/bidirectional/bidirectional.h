@@ -0,0 +1,8 @@
+#ifndef __BIDIRECTIONAL_H__
+#define __BIDIRECTIONAL_H__
+
+#include "../pathfinder/pathfinder.h"
+
+node_t *bidirectional_search(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint32_t goalX, uint32_t goalY);
+
+#endif
@@ -0,0 +1,181 @@
+#include "./cellpool.h"
+#include <stdlib.h>
+#include <string.h>
+
+cell_pool_t *create_cell_pool(arena_t *arena)
+{
+    cell_pool_t *pool = malloc(sizeof(cell_pool_t));
+    if (!pool)
+    {
+        return 0;
+    }
+
+    memset(pool, 0, sizeof(cell_pool_t));
+    if (!refill_cell_pool(pool, arena))
+    {
+        dispose_cell_pool(pool);
+        return 0;
+    }
+
+    return pool;
+}
+
+// Refills the pool with the empty tiles of an arena, its storage is reused unless the arena has more tiles than the
+// pool ever had room for. On failure the pool is left empty.
+int32_t refill_cell_pool(cell_pool_t *pool, arena_t *arena)
+{
+    if (!pool)
+    {
+        return 0;
+    }
+
+    pool->count = 0;
+    pool->deferred = 0;
+    if (!validate_arena(arena) || (uint64_t)arena->width * arena->height >= CELL_POOL_NONE)
+    {
+        return 0;
+    }
+
+    size_t cellCount = (size_t)arena->width * arena->height;
+    if (cellCount > pool->capacity)
+    {
+        free(pool->cells);
+        free(pool->slots);
+        pool->cells = malloc(cellCount * sizeof(uint32_t));
+        pool->slots = malloc(cellCount * sizeof(uint32_t));
+        pool->capacity = pool->cells && pool->slots ? (uint32_t)cellCount : 0;
+        if (!pool->capacity)
+        {
+            return 0;
+        }
+    }
+
+    pool->width = arena->width;
+    pool->height = arena->height;
+    for (uint32_t y = 0; y < arena->height; y++)
+    {
+        for (uint32_t x = 0; x < arena->width; x++)
+        {
+            uint32_t cell = y * arena->width + x;
+            pool->slots[cell] = CELL_POOL_NONE;
+            if (get_tile(arena, x, y) == 0x00)
+            {
+                pool->slots[cell] = pool->count;
+                pool->cells[pool->count++] = cell;
+            }
+        }
+    }
+
+    return 1;
+}
+
+void dispose_cell_pool(cell_pool_t *pool)
+{
+    if (pool)
+    {
+        free(pool->cells);
+        free(pool->slots);
+        free(pool);
+    }
+}
+
+// Picks a uniformly random free tile and leaves it in the pool, returns 0 once the pool is empty
+int32_t cell_pool_pick(cell_pool_t *pool, prng_t *prng, uint32_t *x, uint32_t *y)
+{
+    if (!pool || !pool->count)
+    {
+        return 0;
+    }
+
+    uint32_t cell = pool->cells[prng_below(prng, pool->count)];
+    *x = cell % pool->width;
+    *y = cell / pool->width;
+    return 1;
+}
+
+// Same as cell_pool_pick, but the tile is removed so it cannot be drawn again
+int32_t cell_pool_take(cell_pool_t *pool, prng_t *prng, uint32_t *x, uint32_t *y)
+{
+    if (!cell_pool_pick(pool, prng, x, y))
+    {
+        return 0;
+    }
+
+    cell_pool_remove(pool, *x, *y);
+    return 1;
+}
+
+void cell_pool_place(cell_pool_t *pool, uint32_t cell, uint32_t slot)
+{
+    pool->cells[slot] = cell;
+    pool->slots[cell] = slot;
+}
+
+// Drops a tile that got used some other way, tiles that are not in the pool are ignored
+void cell_pool_remove(cell_pool_t *pool, uint32_t x, uint32_t y)
+{
+    if (!pool || x >= pool->width || y >= pool->height)
+    {
+        return;
+    }
+
+    uint32_t cell = y * pool->width + x;
+    uint32_t slot = pool->slots[cell];
+    if (slot == CELL_POOL_NONE)
+    {
+        return;
+    }
+
+    if (slot < pool->count)
+    {
+        // the last drawable tile fills the hole and the last deferred one the place it left
+        uint32_t lastActive = --pool->count;
+        cell_pool_place(pool, pool->cells[lastActive], slot);
+        if (pool->deferred)
+        {
+            cell_pool_place(pool, pool->cells[lastActive + pool->deferred], lastActive);
+        }
+    }
+    else
+    {
+        pool->deferred--;
+        cell_pool_place(pool, pool->cells[pool->count + pool->deferred], slot);
+    }
+
+    pool->slots[cell] = CELL_POOL_NONE;
+}
+
+// Sets a drawable tile aside so it is not drawn again until the next cell_pool_recall
+void cell_pool_defer(cell_pool_t *pool, uint32_t x, uint32_t y)
+{
+    if (!pool || x >= pool->width || y >= pool->height)
+    {
+        return;
+    }
+
+    uint32_t cell = y * pool->width + x;
+    uint32_t slot = pool->slots[cell];
+    if (slot == CELL_POOL_NONE || slot >= pool->count)
+    {
+        return;
+    }
+
+    uint32_t lastActive = --pool->count;
+    cell_pool_place(pool, pool->cells[lastActive], slot);
+    cell_pool_place(pool, cell, lastActive);
+    pool->deferred++;
+}
+
+// Makes every deferred tile drawable again, returns how many there were
+uint32_t cell_pool_recall(cell_pool_t *pool)
+{
+    if (!pool)
+    {
+        return 0;
+    }
+
+    uint32_t recalled = pool->deferred;
+    pool->count += recalled;
+    pool->deferred = 0;
+    return recalled;
+}
@@ -0,0 +1,32 @@
+#ifndef __CELLPOOL_H__
+#define __CELLPOOL_H__
+
+#include "../arena/arena.h"
+#include "../prng/prng.h"
+
+#define CELL_POOL_NONE UINT32_MAX
+
+// The empty tiles of an arena as a flat array of y * width + x, with the position of every cell in that array so
+// any of them can be removed in O(1) by moving the last one into its place. Picking a random index and removing it
+// is one step of a Fisher-Yates shuffle, so drawing k distinct free tiles costs O(k) however full the arena is.
+// Tiles that cannot be used right now can be deferred behind the drawable ones and recalled later in O(1).
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+    uint32_t count; // tiles that can be drawn, cells[0] to cells[count - 1]
+    uint32_t deferred; // tiles set aside after them until cell_pool_recall
+    uint32_t capacity; // tiles cells and slots have room for
+    uint32_t *cells;
+    uint32_t *slots; // index into cells for every tile, CELL_POOL_NONE for tiles not in the pool
+} cell_pool_t;
+
+cell_pool_t *create_cell_pool(arena_t *arena);
+void dispose_cell_pool(cell_pool_t *pool);
+int32_t refill_cell_pool(cell_pool_t *pool, arena_t *arena);
+int32_t cell_pool_pick(cell_pool_t *pool, prng_t *prng, uint32_t *x, uint32_t *y);
+int32_t cell_pool_take(cell_pool_t *pool, prng_t *prng, uint32_t *x, uint32_t *y);
+void cell_pool_remove(cell_pool_t *pool, uint32_t x, uint32_t y);
+void cell_pool_defer(cell_pool_t *pool, uint32_t x, uint32_t y);
+uint32_t cell_pool_recall(cell_pool_t *pool);
+
+#endif
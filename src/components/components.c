@@ -0,0 +1,311 @@
+#include "./components.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 8-neighbourhood in ring order starting north and going clockwise, even indices are the 4-neighbours
+static const int32_t labelRingX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+static const int32_t labelRingY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+// Roots are always the smallest label of their set, so parent[label] <= label holds everywhere
+uint32_t find_label(component_labels_t *labels, uint32_t label)
+{
+    while (labels->parent[label] != label)
+    {
+        labels->parent[label] = labels->parent[labels->parent[label]];
+        label = labels->parent[label];
+    }
+    return label;
+}
+
+// Returns 1 if the two labels were in different sets
+int32_t union_labels(component_labels_t *labels, uint32_t a, uint32_t b)
+{
+    a = find_label(labels, a);
+    b = find_label(labels, b);
+    if (a == b)
+    {
+        return 0;
+    }
+
+    if (a < b)
+    {
+        labels->parent[b] = a;
+    }
+    else
+    {
+        labels->parent[a] = b;
+    }
+    return 1;
+}
+
+void relabel_components(component_labels_t *labels)
+{
+    arena_t *arena = labels->arena;
+    uint32_t width = arena->width;
+    uint32_t next = 0;
+
+    // first pass hands out provisional labels and records which of them touch through the north neighbour
+    for (uint32_t y = 0; y < arena->height; y++)
+    {
+        const uint64_t *row = arena_passable_row(arena, y);
+        uint32_t *current = labels->labels + (size_t)y * width;
+        for (uint32_t x = 0; x < width; x++)
+        {
+            if (!((row[x / ARENA_WORD_BITS] >> (x % ARENA_WORD_BITS)) & 1))
+            {
+                current[x] = COMPONENT_NONE;
+                continue;
+            }
+
+            uint32_t west = x ? current[x - 1] : COMPONENT_NONE;
+            uint32_t north = y ? (current - width)[x] : COMPONENT_NONE;
+            if (west == COMPONENT_NONE && north == COMPONENT_NONE)
+            {
+                labels->parent[next] = next;
+                current[x] = next++;
+            }
+            else if (west == COMPONENT_NONE)
+            {
+                current[x] = north;
+            }
+            else
+            {
+                current[x] = west;
+                if (north != COMPONENT_NONE && north != west)
+                {
+                    union_labels(labels, west, north);
+                }
+            }
+        }
+    }
+
+    // parents point to smaller labels, so one ascending sweep turns every entry into its final consecutive label
+    uint32_t count = 0;
+    for (uint32_t label = 0; label < next; label++)
+    {
+        labels->parent[label] = labels->parent[label] == label ? count++ : labels->parent[labels->parent[label]];
+    }
+
+    uint64_t cellCount = (uint64_t)width * arena->height;
+    for (uint64_t cell = 0; cell < cellCount; cell++)
+    {
+        if (labels->labels[cell] != COMPONENT_NONE)
+        {
+            labels->labels[cell] = labels->parent[labels->labels[cell]];
+        }
+    }
+
+    for (uint32_t label = 0; label < count; label++)
+    {
+        labels->parent[label] = label;
+    }
+
+    labels->labelCount = count;
+    labels->componentCount = count;
+    labels->journalSequence = arena->journalEnd;
+    labels->stale = 0;
+    labels->relabels++;
+}
+
+
+// Joins a tile that just turned walkable with the components around it
+void label_walkable_tile(component_labels_t *labels, uint32_t x, uint32_t y)
+{
+    arena_t *arena = labels->arena;
+    uint32_t cell = y * arena->width + x;
+    uint32_t label = COMPONENT_NONE;
+    for (uint32_t i = 0; i < 8; i += 2)
+    {
+        int32_t nx = x + labelRingX[i];
+        int32_t ny = y + labelRingY[i];
+        if (nx < 0 || ny < 0 || (uint32_t)nx >= arena->width || (uint32_t)ny >= arena->height)
+        {
+            continue;
+        }
+
+        uint32_t neighbour = labels->labels[ny * arena->width + nx];
+        if (neighbour == COMPONENT_NONE)
+        {
+            continue;
+        }
+
+        if (label == COMPONENT_NONE)
+        {
+            label = neighbour;
+        }
+        else if (union_labels(labels, label, neighbour))
+        {
+            labels->componentCount--;
+        }
+    }
+
+    if (label == COMPONENT_NONE)
+    {
+        if (labels->labelCount == arena->width * arena->height)
+        {
+            labels->stale = 1;
+            return;
+        }
+
+        label = labels->labelCount++;
+        labels->parent[label] = label;
+        labels->componentCount++;
+    }
+
+    labels->labels[cell] = label;
+}
+
+// Removes a tile that just got blocked. Its component can only split when the passable 4-neighbours are not all
+// on one run of passable tiles around it, only then the labels have to be rebuilt.
+void label_blocked_tile(component_labels_t *labels, uint32_t x, uint32_t y)
+{
+    arena_t *arena = labels->arena;
+    labels->labels[y * arena->width + x] = COMPONENT_NONE;
+
+    int32_t passable[8];
+    uint32_t start = 8;
+    uint32_t sides = 0;
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        int32_t nx = x + labelRingX[i];
+        int32_t ny = y + labelRingY[i];
+        passable[i] = nx >= 0 && ny >= 0 && (uint32_t)nx < arena->width && (uint32_t)ny < arena->height && labels->labels[ny * arena->width + nx] != COMPONENT_NONE;
+        sides += i % 2 == 0 && passable[i];
+        if (!passable[i])
+        {
+            start = i;
+        }
+    }
+
+    if (!sides)
+    {
+        labels->componentCount--;
+        return;
+    }
+
+    if (start == 8)
+    {
+        return;
+    }
+
+    // count the runs that hold a 4-neighbour, starting right after a blocked tile so no run is cut in two
+    uint32_t runs = 0;
+    int32_t runHasSide = 0;
+    for (uint32_t step = 1; step <= 8; step++)
+    {
+        uint32_t i = (start + step) % 8;
+        if (passable[i])
+        {
+            runHasSide |= i % 2 == 0;
+            continue;
+        }
+
+        runs += runHasSide;
+        runHasSide = 0;
+    }
+
+    if (runs > 1)
+    {
+        labels->stale = 1;
+    }
+}
+
+// Replays the arena journal since the last query, relabels when changes were missed or a component may have split
+void refresh_components(component_labels_t *labels)
+{
+    arena_t *arena = labels->arena;
+    if (!labels->stale && arena_journal_covers(arena, labels->journalSequence))
+    {
+        for (; labels->journalSequence < arena->journalEnd && !labels->stale; labels->journalSequence++)
+        {
+            const arena_change_t *change = arena_change_at(arena, labels->journalSequence);
+            int32_t walkable = is_walkable_tile(change->newType);
+            if (walkable == is_walkable_tile(change->oldType))
+            {
+                continue;
+            }
+
+            if (walkable)
+            {
+                label_walkable_tile(labels, change->x, change->y);
+            }
+            else
+            {
+                label_blocked_tile(labels, change->x, change->y);
+            }
+        }
+    }
+
+    if (labels->stale || labels->journalSequence != arena->journalEnd)
+    {
+        relabel_components(labels);
+    }
+}
+
+component_labels_t *create_component_labels(arena_t *arena)
+{
+    if (!validate_arena(arena) || (uint64_t)arena->width * arena->height >= COMPONENT_NONE)
+    {
+        return 0;
+    }
+
+    component_labels_t *labels = malloc(sizeof(component_labels_t));
+    if (!labels)
+    {
+        return 0;
+    }
+
+    memset(labels, 0, sizeof(component_labels_t));
+    labels->arena = arena;
+    size_t cellCount = (size_t)arena->width * arena->height;
+    labels->labels = malloc(cellCount * sizeof(uint32_t));
+    labels->parent = malloc(cellCount * sizeof(uint32_t));
+    if (!labels->labels || !labels->parent)
+    {
+        dispose_component_labels(labels);
+        return 0;
+    }
+
+    relabel_components(labels);
+    return labels;
+}
+
+void dispose_component_labels(component_labels_t *labels)
+{
+    if (labels)
+    {
+        free(labels->labels);
+        free(labels->parent);
+        free(labels);
+    }
+}
+
+// Returns the component of a tile, COMPONENT_NONE for blocked tiles and coordinates outside the arena
+uint32_t component_of(component_labels_t *labels, uint32_t x, uint32_t y)
+{
+    if (!labels || x >= labels->arena->width || y >= labels->arena->height)
+    {
+        return COMPONENT_NONE;
+    }
+
+    refresh_components(labels);
+    uint32_t label = labels->labels[(size_t)y * labels->arena->width + x];
+    return label == COMPONENT_NONE ? COMPONENT_NONE : find_label(labels, label);
+}
+
+int32_t components_connected(component_labels_t *labels, uint32_t x1, uint32_t y1, uint32_t x2, uint32_t y2)
+{
+    uint32_t a = component_of(labels, x1, y1);
+    return a != COMPONENT_NONE && a == component_of(labels, x2, y2);
+}
+
+uint32_t component_count(component_labels_t *labels)
+{
+    if (!labels)
+    {
+        return 0;
+    }
+
+    refresh_components(labels);
+    return labels->componentCount;
+}
@@ -0,0 +1,30 @@
+#ifndef __COMPONENTS_H__
+#define __COMPONENTS_H__
+
+#include "../arena/arena.h"
+
+#define COMPONENT_NONE UINT32_MAX
+
+// Labels every passable tile with the 4-connected component it belongs to, so reachability is one comparison.
+// Labels come from a two-pass raster scan with a union find over provisional labels, indexed y * width + x.
+// Queries first replay the arena journal: a tile turning walkable only merges components and is applied in place,
+// a tile turning blocked is applied in place when its passable neighbours stay joined around it. A possible split
+// or changes that already fell out of the journal relabel everything.
+typedef struct component_labels_t {
+    arena_t *arena;
+    uint32_t *labels; // COMPONENT_NONE for blocked tiles
+    uint32_t *parent; // label equivalences, one slot per tile so provisional labels can never run out
+    uint32_t labelCount;
+    uint32_t componentCount;
+    uint64_t journalSequence; // arena changes before this one are reflected in the labels
+    int32_t stale;
+    uint32_t relabels;
+} component_labels_t;
+
+component_labels_t *create_component_labels(arena_t *arena);
+void dispose_component_labels(component_labels_t *labels);
+uint32_t component_of(component_labels_t *labels, uint32_t x, uint32_t y);
+int32_t components_connected(component_labels_t *labels, uint32_t x1, uint32_t y1, uint32_t x2, uint32_t y2);
+uint32_t component_count(component_labels_t *labels);
+
+#endif
@@ -0,0 +1,223 @@
+#include "./connectivity.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 8-neighbourhood in ring order starting north and going clockwise, even indices are the 4-neighbours
+static const int32_t ringX[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+static const int32_t ringY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+int32_t is_blocked(arena_t *arena, int32_t x, int32_t y)
+{
+    if (x < 0 || y < 0 || (uint32_t)x >= arena->width || (uint32_t)y >= arena->height)
+    {
+        return 1;
+    }
+    return !arena_is_passable(arena, x, y);
+}
+
+uint32_t node_of(connectivity_checker_t *checker, int32_t x, int32_t y)
+{
+    arena_t *arena = checker->arena;
+    if (x < 0 || y < 0 || (uint32_t)x >= arena->width || (uint32_t)y >= arena->height)
+    {
+        return checker->outside;
+    }
+    return y * arena->width + x;
+}
+
+uint32_t find_set(connectivity_checker_t *checker, uint32_t node)
+{
+    while (checker->parent[node] != node)
+    {
+        checker->parent[node] = checker->parent[checker->parent[node]];
+        node = checker->parent[node];
+    }
+    return node;
+}
+
+void union_sets(connectivity_checker_t *checker, uint32_t a, uint32_t b)
+{
+    a = find_set(checker, a);
+    b = find_set(checker, b);
+    if (a == b)
+    {
+        return;
+    }
+
+    if (checker->rank[a] < checker->rank[b])
+    {
+        uint32_t swap = a;
+        a = b;
+        b = swap;
+    }
+    checker->parent[b] = a;
+    if (checker->rank[a] == checker->rank[b])
+    {
+        checker->rank[a]++;
+    }
+}
+
+void join_blocked_neighbours(connectivity_checker_t *checker, int32_t x, int32_t y)
+{
+    uint32_t node = node_of(checker, x, y);
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        if (is_blocked(checker->arena, x + ringX[i], y + ringY[i]))
+        {
+            union_sets(checker, node, node_of(checker, x + ringX[i], y + ringY[i]));
+        }
+    }
+}
+
+void rebuild_sets(connectivity_checker_t *checker)
+{
+    arena_t *arena = checker->arena;
+    for (uint32_t i = 0; i <= checker->outside; i++)
+    {
+        checker->parent[i] = i;
+    }
+    memset(checker->rank, 0, checker->outside + 1);
+
+    for (int32_t y = 0; y < arena->height; y++)
+    {
+        for (int32_t x = 0; x < arena->width; x++)
+        {
+            if (!arena_is_passable(arena, x, y))
+            {
+                join_blocked_neighbours(checker, x, y);
+            }
+        }
+    }
+
+    checker->journalSequence = arena->journalEnd;
+    checker->rebuilds++;
+}
+
+// Blocked tiles are joined in from the arena journal, a tile that turned walkable can split a set and rebuilds them
+void sync_sets(connectivity_checker_t *checker)
+{
+    arena_t *arena = checker->arena;
+    if (!arena_journal_covers(arena, checker->journalSequence))
+    {
+        rebuild_sets(checker);
+        return;
+    }
+
+    for (uint64_t sequence = checker->journalSequence; sequence < arena->journalEnd; sequence++)
+    {
+        const arena_change_t *change = arena_change_at(arena, sequence);
+        if (is_walkable_tile(change->newType) && !is_walkable_tile(change->oldType))
+        {
+            rebuild_sets(checker);
+            return;
+        }
+    }
+
+    for (; checker->journalSequence < arena->journalEnd; checker->journalSequence++)
+    {
+        const arena_change_t *change = arena_change_at(arena, checker->journalSequence);
+        if (!is_walkable_tile(change->newType) && is_walkable_tile(change->oldType))
+        {
+            join_blocked_neighbours(checker, change->x, change->y);
+        }
+    }
+}
+
+connectivity_checker_t *create_connectivity_checker(arena_t *arena)
+{
+    if (!validate_arena(arena) || (uint64_t)arena->width * arena->height >= UINT32_MAX)
+    {
+        return 0;
+    }
+
+    connectivity_checker_t *checker = malloc(sizeof(connectivity_checker_t));
+    if (!checker)
+    {
+        return 0;
+    }
+
+    memset(checker, 0, sizeof(connectivity_checker_t));
+    checker->arena = arena;
+    checker->outside = arena->width * arena->height;
+    checker->parent = malloc((checker->outside + 1) * sizeof(uint32_t));
+    checker->rank = malloc((checker->outside + 1) * sizeof(uint8_t));
+    if (!checker->parent || !checker->rank)
+    {
+        dispose_connectivity_checker(checker);
+        return 0;
+    }
+
+    rebuild_sets(checker);
+    return checker;
+}
+
+void dispose_connectivity_checker(connectivity_checker_t *checker)
+{
+    if (checker)
+    {
+        free(checker->parent);
+        free(checker->rank);
+        free(checker);
+    }
+}
+
+// The blocked cells around (x, y) fall into gaps between the passable 4-neighbours, blocking the cell joins all of
+// them. Passable space only splits when that closes a loop of blocked cells, which happens exactly when two gaps
+// already belong to the same set.
+int32_t would_disconnect(connectivity_checker_t *checker, uint32_t x, uint32_t y)
+{
+    if (!checker)
+    {
+        return 1;
+    }
+
+    arena_t *arena = checker->arena;
+    checker->checks++;
+    sync_sets(checker);
+
+    // walk the ring starting just after a passable 4-neighbour so no gap is cut in two
+    uint32_t start = 8;
+    for (uint32_t i = 0; i < 8 && start == 8; i += 2)
+    {
+        if (!is_blocked(arena, x + ringX[i], y + ringY[i]))
+        {
+            start = i;
+        }
+    }
+
+    if (start == 8)
+    {
+        return 0;
+    }
+
+    uint32_t gaps[CONNECTIVITY_MAX_SIDES];
+    uint32_t gapCount = 0;
+    int32_t sideSeen = 1;
+    for (uint32_t step = 1; step < 8; step++)
+    {
+        uint32_t i = (start + step) % 8;
+        int32_t nx = x + ringX[i];
+        int32_t ny = y + ringY[i];
+        if (!is_blocked(arena, nx, ny))
+        {
+            sideSeen |= i % 2 == 0;
+            continue;
+        }
+
+        if (sideSeen)
+        {
+            uint32_t gap = find_set(checker, node_of(checker, nx, ny));
+            for (uint32_t j = 0; j < gapCount; j++)
+            {
+                if (gaps[j] == gap)
+                {
+                    return 1;
+                }
+            }
+            gaps[gapCount++] = gap;
+            sideSeen = 0;
+        }
+    }
+
+    return 0;
+}
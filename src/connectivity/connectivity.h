@@ -0,0 +1,26 @@
+#ifndef __CONNECTIVITY_H__
+#define __CONNECTIVITY_H__
+
+#include "../arena/arena.h"
+
+#define CONNECTIVITY_MAX_SIDES 4
+
+// Answers whether blocking one more cell would split the passable area of an arena that is connected now.
+// Blocked cells are kept in a union find over 8-connectivity, everything outside the arena is one more node.
+// Blocking only ever merges sets, so blocked tiles are joined in from the arena journal before every check, any
+// other change to the arena rebuilds the sets from scratch.
+typedef struct {
+    arena_t *arena;
+    uint64_t journalSequence; // arena changes before this one are reflected in the sets
+    uint32_t outside;
+    uint32_t *parent;
+    uint8_t *rank;
+    uint32_t checks;
+    uint32_t rebuilds;
+} connectivity_checker_t;
+
+connectivity_checker_t *create_connectivity_checker(arena_t *arena);
+void dispose_connectivity_checker(connectivity_checker_t *checker);
+int32_t would_disconnect(connectivity_checker_t *checker, uint32_t x, uint32_t y);
+
+#endif
@@ -12,5 +12,7 @@
 #define MAX_MARKER_AREA_PERCENTAGE 0.1
 #define ROBOT_BORDER_COLOR 0x172269
 #define ROBOT_FILL_COLOR 0x31409e
+#define BATCH_THREAD_COUNT 4
+#define QUEUE_BENCHMARK_ROUNDS 100
 
 #endif
\ No newline at end of file
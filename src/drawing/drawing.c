@@ -6,6 +6,7 @@
 // Last drawn arena, there can only be 1 actively drawn arena at a time.
 static int _isArenaDrawn = 0;
 static arena_draw_parameters_t _currentArenaParameters;
+static uint64_t _drawnJournalSequence = 0; // arena changes before this one are on the background layer
 
 void set_color_from_uint32(uint32_t color)
 {
@@ -92,9 +93,35 @@ void draw_arena(arena_draw_parameters_t parameters)
     draw_grid(parameters.arena, parameters.paddingSize, parameters.backgroundColor0RGB, parameters.pixelPerSide);
     
     _currentArenaParameters = parameters;
+    _drawnJournalSequence = parameters.arena->journalEnd;
     _isArenaDrawn = 1;
 }
 
+// Repaints the background tiles changed since the arena was last drawn, or all of them once the journal lost track
+void draw_changed_tiles()
+{
+    arena_t *arena = _currentArenaParameters.arena;
+    if (!_isArenaDrawn || !validate_arena(arena))
+    {
+        return;
+    }
+
+    uint32_t paddingSize = _currentArenaParameters.paddingSize;
+    uint32_t pixelPerSide = _currentArenaParameters.pixelPerSide;
+    if (!arena_journal_covers(arena, _drawnJournalSequence))
+    {
+        draw_grid(arena, paddingSize, _currentArenaParameters.backgroundColor0RGB, pixelPerSide);
+        _drawnJournalSequence = arena->journalEnd;
+        return;
+    }
+
+    for (; _drawnJournalSequence < arena->journalEnd; _drawnJournalSequence++)
+    {
+        const arena_change_t *change = arena_change_at(arena, _drawnJournalSequence);
+        draw_tile(change->newType, pixelPerSide, paddingSize + change->x * pixelPerSide, paddingSize + change->y * pixelPerSide, _currentArenaParameters.backgroundColor0RGB);
+    }
+}
+
 void update_arena()
 {
     if (!_isArenaDrawn || !validate_arena(_currentArenaParameters.arena))
@@ -205,12 +232,15 @@ void draw_arena_markers(arena_t *arena)
         return;
     }
 
-    for(int y = 0; y < arena->height; y++)
+    // walks the set bits of the marker plane instead of looking at every tile
+    for (uint32_t y = 0; y < arena->height; y++)
     {
-        for(int x = 0; x < arena->width; x++)
+        const uint64_t *row = arena_marker_row(arena, y);
+        for (uint32_t word = 0; word < arena->wordsPerRow; word++)
         {
-            if(get_tile(arena, x, y) == 0x02)
+            for (uint64_t bits = row[word]; bits; bits &= bits - 1)
             {
+                uint32_t x = word * ARENA_WORD_BITS + __builtin_ctzll(bits);
                 int markerX = _currentArenaParameters.paddingSize + x * _currentArenaParameters.pixelPerSide;
                 int markerY = _currentArenaParameters.paddingSize + y * _currentArenaParameters.pixelPerSide;
 
@@ -231,6 +261,7 @@ void draw_robot(robot_draw_parameters_t parameters)
         return;
     }
 
+    draw_changed_tiles();
     foreground();
     clear();
 
@@ -0,0 +1,421 @@
+#include "./dstarlite.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Implementation details inspired from Koenig and Likhachev, "D* Lite" (optimized version)
+
+#define DSTAR_INFINITY UINT32_MAX
+#define DSTAR_MAX_KEY_MODIFIER (1u << 30)
+
+static const int32_t neighborX[4] = {0, 1, 0, -1};
+static const int32_t neighborY[4] = {-1, 0, 1, 0};
+
+dstar_lite_t *create_dstar_lite(pathfinder_t *pathfinder)
+{
+    if (!pathfinder)
+    {
+        return 0;
+    }
+
+    dstar_lite_t *planner = malloc(sizeof(dstar_lite_t));
+    if (!planner)
+    {
+        return 0;
+    }
+
+    memset(planner, 0, sizeof(dstar_lite_t));
+    planner->pathfinder = pathfinder;
+    planner->g = malloc(pathfinder->cellCount * sizeof(uint32_t));
+    planner->rhs = malloc(pathfinder->cellCount * sizeof(uint32_t));
+    planner->slot = calloc(pathfinder->cellCount, sizeof(uint32_t));
+    planner->stamp = calloc(pathfinder->cellCount, sizeof(uint32_t));
+    if (!planner->g || !planner->rhs || !planner->slot || !planner->stamp)
+    {
+        dispose_dstar_lite(planner);
+        return 0;
+    }
+
+    planner->openList = create_index_min_heap(pathfinder->cellCount, planner->slot);
+    if (!planner->openList)
+    {
+        dispose_dstar_lite(planner);
+        return 0;
+    }
+
+    return planner;
+}
+
+void dispose_dstar_lite(dstar_lite_t *planner)
+{
+    if (planner)
+    {
+        dispose_index_min_heap(planner->openList);
+        free(planner->g);
+        free(planner->rhs);
+        free(planner->slot);
+        free(planner->stamp);
+        free(planner);
+    }
+}
+
+void touch_cell(dstar_lite_t *planner, uint32_t cell)
+{
+    if (planner->stamp[cell] != planner->generation)
+    {
+        planner->stamp[cell] = planner->generation;
+        planner->g[cell] = DSTAR_INFINITY;
+        planner->rhs[cell] = DSTAR_INFINITY;
+    }
+}
+
+uint32_t get_g(dstar_lite_t *planner, uint32_t cell)
+{
+    return planner->stamp[cell] == planner->generation ? planner->g[cell] : DSTAR_INFINITY;
+}
+
+uint32_t get_rhs(dstar_lite_t *planner, uint32_t cell)
+{
+    return planner->stamp[cell] == planner->generation ? planner->rhs[cell] : DSTAR_INFINITY;
+}
+
+uint32_t cell_distance(dstar_lite_t *planner, uint32_t a, uint32_t b)
+{
+    arena_t *arena = planner->pathfinder->arena;
+    return heuristic(arena_cell_x(arena, a), arena_cell_y(arena, a), arena_cell_x(arena, b), arena_cell_y(arena, b));
+}
+
+// Both keys packed into one integer so they compare lexicographically, unreachable cells sort last
+uint64_t calculate_key(dstar_lite_t *planner, uint32_t cell)
+{
+    uint32_t g = get_g(planner, cell);
+    uint32_t rhs = get_rhs(planner, cell);
+    uint32_t k2 = g < rhs ? g : rhs;
+    if (k2 == DSTAR_INFINITY)
+    {
+        return UINT64_MAX;
+    }
+
+    uint64_t k1 = (uint64_t)k2 + cell_distance(planner, planner->startCell, cell) + planner->keyModifier;
+    return (k1 << 32) | k2;
+}
+
+// Moves between two cells cost 1 when both are walkable, the cost is symmetric so successors and predecessors coincide
+int32_t cell_walkable(dstar_lite_t *planner, uint32_t cell)
+{
+    arena_t *arena = planner->pathfinder->arena;
+    return pf_is_walkable(planner->pathfinder, arena_cell_x(arena, cell), arena_cell_y(arena, cell));
+}
+
+// Fills neighbors with the adjacent cells inside the arena and returns how many there are
+uint32_t get_neighbors(dstar_lite_t *planner, uint32_t cell, uint32_t neighbors[4])
+{
+    arena_t *arena = planner->pathfinder->arena;
+    uint32_t width = planner->pathfinder->width;
+    uint32_t height = planner->pathfinder->height;
+    int32_t x = arena_cell_x(arena, cell);
+    int32_t y = arena_cell_y(arena, cell);
+    uint32_t count = 0;
+    for (int32_t i = 0; i < 4; i++)
+    {
+        int32_t nx = x + neighborX[i];
+        int32_t ny = y + neighborY[i];
+        if (nx >= 0 && ny >= 0 && nx < width && ny < height)
+        {
+            neighbors[count++] = arena_cell_index(arena, nx, ny);
+        }
+    }
+    return count;
+}
+
+uint32_t lowest_successor_cost(dstar_lite_t *planner, uint32_t cell)
+{
+    if (!cell_walkable(planner, cell))
+    {
+        return DSTAR_INFINITY;
+    }
+
+    uint32_t best = DSTAR_INFINITY;
+    uint32_t neighbors[4];
+    uint32_t count = get_neighbors(planner, cell, neighbors);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t g = get_g(planner, neighbors[i]);
+        if (g != DSTAR_INFINITY && g + 1 < best && cell_walkable(planner, neighbors[i]))
+        {
+            best = g + 1;
+        }
+    }
+    return best;
+}
+
+void update_vertex(dstar_lite_t *planner, uint32_t cell)
+{
+    int32_t queued = imh_contains(planner->openList, cell);
+    int32_t consistent = get_g(planner, cell) == get_rhs(planner, cell);
+    if (!consistent && queued)
+    {
+        imh_update_key(planner->openList, cell, calculate_key(planner, cell));
+    }
+    else if (!consistent)
+    {
+        imh_insert(planner->openList, cell, calculate_key(planner, cell));
+    }
+    else if (queued)
+    {
+        imh_remove(planner->openList, cell);
+    }
+    planner->pathfinder->stats.heapOperations++;
+}
+
+void recompute_rhs(dstar_lite_t *planner, uint32_t cell)
+{
+    if (cell == planner->goalCell)
+    {
+        return;
+    }
+
+    touch_cell(planner, cell);
+    planner->rhs[cell] = lowest_successor_cost(planner, cell);
+    update_vertex(planner, cell);
+}
+
+// Starts a new search towards the goal, all previous values are dropped
+void dstar_lite_set_goal(dstar_lite_t *planner, uint32_t goalX, uint32_t goalY)
+{
+    if (!planner || goalX >= planner->pathfinder->width || goalY >= planner->pathfinder->height)
+    {
+        return;
+    }
+
+    planner->generation++;
+    if (planner->generation == 0) // wrapped around, old stamps could collide with new generations
+    {
+        memset(planner->stamp, 0, planner->pathfinder->cellCount * sizeof(uint32_t));
+        planner->generation = 1;
+    }
+
+    imh_clear(planner->openList);
+    planner->goalCell = arena_cell_index(planner->pathfinder->arena, goalX, goalY);
+    planner->keyModifier = 0;
+    planner->hasGoal = 1;
+
+    touch_cell(planner, planner->goalCell);
+    planner->rhs[planner->goalCell] = 0;
+    imh_insert(planner->openList, planner->goalCell, calculate_key(planner, planner->goalCell));
+}
+
+// Every key in the queue was computed for an older start, raising the modifier by the distance moved keeps
+// them lower bounds. Once the modifier gets large all keys are recomputed for the current start instead.
+void move_start(dstar_lite_t *planner, uint32_t cell)
+{
+    planner->keyModifier += cell_distance(planner, planner->startCell, cell);
+    planner->startCell = cell;
+    if (planner->keyModifier < DSTAR_MAX_KEY_MODIFIER)
+    {
+        return;
+    }
+
+    planner->keyModifier = 0;
+    index_min_heap_t *openList = planner->openList;
+    for (uint32_t i = 0; i < openList->size; i++)
+    {
+        openList->keys[i] = calculate_key(planner, openList->cells[i]);
+    }
+    imh_heapify(openList);
+}
+
+void dstar_lite_set_start(dstar_lite_t *planner, uint32_t startX, uint32_t startY)
+{
+    if (planner && startX < planner->pathfinder->width && startY < planner->pathfinder->height)
+    {
+        move_start(planner, arena_cell_index(planner->pathfinder->arena, startX, startY));
+    }
+}
+
+// Must be called after the passability of a tile changes, only the tile and its neighbours are revisited
+void dstar_lite_notify_tile_changed(dstar_lite_t *planner, uint32_t x, uint32_t y)
+{
+    if (!planner || !planner->hasGoal || x >= planner->pathfinder->width || y >= planner->pathfinder->height)
+    {
+        return;
+    }
+
+    uint32_t cell = arena_cell_index(planner->pathfinder->arena, x, y);
+    uint32_t neighbors[4];
+    uint32_t count = get_neighbors(planner, cell, neighbors);
+    recompute_rhs(planner, cell);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        recompute_rhs(planner, neighbors[i]);
+    }
+}
+
+void compute_shortest_path(dstar_lite_t *planner)
+{
+    uint32_t start = planner->startCell;
+    while (imh_min_key(planner->openList) < calculate_key(planner, start) || get_rhs(planner, start) > get_g(planner, start))
+    {
+        uint64_t oldKey = imh_min_key(planner->openList);
+        if (oldKey == UINT64_MAX)
+        {
+            return;
+        }
+
+        uint32_t cell = planner->openList->cells[0];
+        uint64_t newKey = calculate_key(planner, cell);
+        planner->pathfinder->stats.heapOperations++;
+        if (oldKey < newKey)
+        {
+            imh_update_key(planner->openList, cell, newKey);
+            continue;
+        }
+
+        planner->pathfinder->stats.expandedNodes++;
+        imh_remove(planner->openList, cell);
+
+        uint32_t neighbors[4];
+        uint32_t count = get_neighbors(planner, cell, neighbors);
+        if (planner->g[cell] > planner->rhs[cell])
+        {
+            // overconsistent, the cell settles and can only lower its neighbours
+            planner->g[cell] = planner->rhs[cell];
+            if (!cell_walkable(planner, cell))
+            {
+                continue;
+            }
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                uint32_t neighbor = neighbors[i];
+                if (neighbor == planner->goalCell || !cell_walkable(planner, neighbor))
+                {
+                    continue;
+                }
+
+                touch_cell(planner, neighbor);
+                if (planner->g[cell] + 1 < planner->rhs[neighbor])
+                {
+                    planner->rhs[neighbor] = planner->g[cell] + 1;
+                    update_vertex(planner, neighbor);
+                }
+            }
+        }
+        else
+        {
+            // underconsistent, neighbours that relied on the old value have to look elsewhere
+            uint32_t oldG = planner->g[cell];
+            planner->g[cell] = DSTAR_INFINITY;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                if (get_rhs(planner, neighbors[i]) == oldG + 1)
+                {
+                    recompute_rhs(planner, neighbors[i]);
+                }
+            }
+            recompute_rhs(planner, cell);
+            if (cell == planner->goalCell)
+            {
+                update_vertex(planner, cell);
+            }
+        }
+    }
+}
+
+// Lowest start-to-goal distance known for the current start, DSTAR_INFINITY when the goal is unreachable
+uint32_t start_distance(dstar_lite_t *planner)
+{
+    uint32_t g = get_g(planner, planner->startCell);
+    uint32_t rhs = get_rhs(planner, planner->startCell);
+    return g < rhs ? g : rhs;
+}
+
+// Repairs the search for the current start and walks down the g values to the goal. Every cell whose key is below
+// the start's is settled once compute_shortest_path returns, which includes every cell on a shortest path from the
+// start, so one repair is enough and the descent only looks at the neighbours of the cells it passes.
+node_t *dstar_lite_plan(dstar_lite_t *planner)
+{
+    if (!planner || !planner->hasGoal)
+    {
+        return 0;
+    }
+
+    compute_shortest_path(planner);
+
+    uint32_t length = start_distance(planner);
+    if (length == DSTAR_INFINITY || !cell_walkable(planner, planner->startCell))
+    {
+        return 0;
+    }
+
+    uint32_t *cells = malloc((length + 1) * sizeof(uint32_t));
+    if (!cells)
+    {
+        return 0;
+    }
+
+    uint32_t count = 0;
+    uint32_t cell = planner->startCell;
+    cells[count++] = cell;
+    while (cell != planner->goalCell && count <= length)
+    {
+        uint32_t next = DSTAR_INFINITY;
+        uint32_t best = DSTAR_INFINITY;
+        uint32_t neighbors[4];
+        uint32_t neighborCount = get_neighbors(planner, cell, neighbors);
+        for (uint32_t i = 0; i < neighborCount; i++)
+        {
+            uint32_t g = get_g(planner, neighbors[i]);
+            if (g < best && cell_walkable(planner, neighbors[i]))
+            {
+                best = g;
+                next = neighbors[i];
+            }
+        }
+
+        if (next == DSTAR_INFINITY)
+        {
+            break;
+        }
+
+        cell = next;
+        cells[count++] = cell;
+    }
+
+    node_t *path = 0;
+    if (cell == planner->goalCell)
+    {
+        arena_t *arena = planner->pathfinder->arena;
+        path = pf_build_path_from_cells(planner->pathfinder, cells, count, arena_cell_x(arena, planner->goalCell), arena_cell_y(arena, planner->goalCell));
+    }
+
+    free(cells);
+    return path;
+}
+
+// Keeps the previous search when the goal is unchanged, so consecutive queries from a moving start are incremental
+node_t *dstar_lite_search(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint32_t goalX, uint32_t goalY)
+{
+    if (!pathfinder || startX >= pathfinder->width || startY >= pathfinder->height || goalX >= pathfinder->width || goalY >= pathfinder->height)
+    {
+        return 0;
+    }
+
+    pf_sync_changes(pathfinder);
+    if (!pathfinder->dstarLite)
+    {
+        pathfinder->dstarLite = create_dstar_lite(pathfinder);
+        if (!pathfinder->dstarLite)
+        {
+            return 0;
+        }
+    }
+
+    dstar_lite_t *planner = pathfinder->dstarLite;
+    dstar_lite_set_start(planner, startX, startY);
+    if (!planner->hasGoal || planner->goalCell != arena_cell_index(pathfinder->arena, goalX, goalY))
+    {
+        dstar_lite_set_goal(planner, goalX, goalY);
+    }
+
+    return dstar_lite_plan(planner);
+}
@@ -0,0 +1,32 @@
+#ifndef __DSTARLITE_H__
+#define __DSTARLITE_H__
+
+#include "../pathfinder/pathfinder.h"
+#include "../minheap/minheap.h"
+
+// Incremental planner (D* Lite) that searches backwards from the goal and keeps its g/rhs values between
+// queries, so moving the start or changing a few tiles only repairs the affected part of the search.
+// Values are only meaningful when stamp[cell] == generation, a new goal invalidates them in O(1).
+typedef struct dstar_lite_t {
+    pathfinder_t *pathfinder;
+    uint32_t generation;
+    uint32_t *g;
+    uint32_t *rhs;
+    uint32_t *slot;
+    uint32_t *stamp;
+    index_min_heap_t *openList;
+    uint32_t startCell;
+    uint32_t goalCell;
+    uint32_t keyModifier;
+    int32_t hasGoal;
+} dstar_lite_t;
+
+dstar_lite_t *create_dstar_lite(pathfinder_t *pathfinder);
+void dispose_dstar_lite(dstar_lite_t *planner);
+void dstar_lite_set_goal(dstar_lite_t *planner, uint32_t goalX, uint32_t goalY);
+void dstar_lite_set_start(dstar_lite_t *planner, uint32_t startX, uint32_t startY);
+void dstar_lite_notify_tile_changed(dstar_lite_t *planner, uint32_t x, uint32_t y);
+node_t *dstar_lite_plan(dstar_lite_t *planner);
+node_t *dstar_lite_search(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint32_t goalX, uint32_t goalY);
+
+#endif
@@ -0,0 +1,169 @@
+#include "./floodfill.h"
+#include <string.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Occluded fill towards bit 0 in log steps (Kogge-Stone), seeds must be a subset of passable
+uint64_t fill_toward_low_bits(uint64_t seeds, uint64_t passable)
+{
+    seeds |= passable & (seeds >> 1);
+    passable &= passable >> 1;
+    seeds |= passable & (seeds >> 2);
+    passable &= passable >> 2;
+    seeds |= passable & (seeds >> 4);
+    passable &= passable >> 4;
+    seeds |= passable & (seeds >> 8);
+    passable &= passable >> 8;
+    seeds |= passable & (seeds >> 16);
+    passable &= passable >> 16;
+    seeds |= passable & (seeds >> 32);
+    return seeds;
+}
+
+// Fill towards the top bit with one addition: the carry out of every seed runs through the rest of its passable
+// run, seeds are or-ed back in because two seeds in the same run cancel each other's carry bit
+uint64_t fill_toward_high_bits(uint64_t seeds, uint64_t passable)
+{
+    return (((passable + seeds) ^ passable) | seeds) & passable;
+}
+
+// Adds the reached cells of the neighbouring row to this one, returns non zero if anything was added
+uint64_t merge_vertical(const uint64_t *passable, uint64_t *row, const uint64_t *neighbor, uint32_t words)
+{
+    uint64_t changed = 0;
+    uint32_t w = 0;
+#ifdef __AVX2__
+    __m256i changedLanes = _mm256_setzero_si256();
+    for (; w + 4 <= words; w += 4)
+    {
+        __m256i old = _mm256_loadu_si256((const __m256i *)&row[w]);
+        __m256i grown = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)&neighbor[w]), _mm256_loadu_si256((const __m256i *)&passable[w]));
+        changedLanes = _mm256_or_si256(changedLanes, _mm256_andnot_si256(old, grown));
+        _mm256_storeu_si256((__m256i *)&row[w], _mm256_or_si256(old, grown));
+    }
+    changed = !_mm256_testz_si256(changedLanes, changedLanes);
+#endif
+    for (; w < words; w++)
+    {
+        uint64_t grown = neighbor[w] & passable[w];
+        changed |= grown & ~row[w];
+        row[w] |= grown;
+    }
+
+    return changed;
+}
+
+// Spreads the reached cells of a row along its passable runs, carrying across word boundaries both ways
+void fill_row(const uint64_t *passable, uint64_t *row, uint32_t words)
+{
+    uint64_t carry = 0;
+    for (uint32_t w = 0; w < words; w++)
+    {
+        uint64_t filled = fill_toward_high_bits((row[w] | carry) & passable[w], passable[w]);
+        row[w] = filled;
+        carry = filled >> 63;
+    }
+
+    carry = 0;
+    for (uint32_t w = words; w > 0; w--)
+    {
+        uint64_t filled = fill_toward_low_bits((row[w - 1] | (carry << 63)) & passable[w - 1], passable[w - 1]);
+        row[w - 1] = filled;
+        carry = filled & 1;
+    }
+}
+
+// Marks every passable cell connected to the start in reached and returns how many there are. The reached set
+// grows one row at a time in alternating downward and upward sweeps until a full round adds nothing.
+// reached must hold wordsPerRow * height words and is cleared first.
+uint64_t flood_fill_passable(arena_t *arena, uint32_t startX, uint32_t startY, uint64_t *reached)
+{
+    if (!arena_is_passable(arena, startX, startY) || !reached)
+    {
+        return 0;
+    }
+
+    uint64_t words = arena->wordsPerRow;
+    memset(reached, 0, words * arena->height * sizeof(uint64_t));
+    reached[startY * words + startX / ARENA_WORD_BITS] = (uint64_t)1 << (startX % ARENA_WORD_BITS);
+
+    fill_row(arena_passable_row(arena, startY), &reached[startY * words], words);
+
+    uint64_t changed;
+    do
+    {
+        changed = 0;
+        for (uint32_t y = 1; y < arena->height; y++)
+        {
+            uint64_t *row = &reached[y * words];
+            const uint64_t *passable = arena_passable_row(arena, y);
+            if (merge_vertical(passable, row, row - words, words))
+            {
+                fill_row(passable, row, words);
+                changed = 1;
+            }
+        }
+
+        for (uint32_t y = arena->height - 1; y > 0; y--)
+        {
+            uint64_t *row = &reached[(y - 1) * words];
+            const uint64_t *passable = arena_passable_row(arena, y - 1);
+            if (merge_vertical(passable, row, row + words, words))
+            {
+                fill_row(passable, row, words);
+                changed = 1;
+            }
+        }
+    } while (changed);
+
+    uint64_t count = 0;
+    for (uint64_t i = 0; i < words * arena->height; i++)
+    {
+        count += __builtin_popcountll(reached[i]);
+    }
+    return count;
+}
+
+uint64_t count_passable(arena_t *arena)
+{
+    if (!validate_arena(arena))
+    {
+        return 0;
+    }
+
+    uint64_t count = 0;
+    for (uint32_t y = 0; y < arena->height; y++)
+    {
+        const uint64_t *passable = arena_passable_row(arena, y);
+        for (uint32_t w = 0; w < arena->wordsPerRow; w++)
+        {
+            count += __builtin_popcountll(passable[w]);
+        }
+    }
+    return count;
+}
+
+// First passable cell in row-major order, returns 0 when there is none
+int32_t find_passable(arena_t *arena, uint32_t *x, uint32_t *y)
+{
+    if (!validate_arena(arena))
+    {
+        return 0;
+    }
+
+    for (uint32_t row = 0; row < arena->height; row++)
+    {
+        const uint64_t *passable = arena_passable_row(arena, row);
+        for (uint32_t w = 0; w < arena->wordsPerRow; w++)
+        {
+            if (passable[w])
+            {
+                *y = row;
+                *x = w * ARENA_WORD_BITS + __builtin_ctzll(passable[w]);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,11 @@
+#ifndef __FLOODFILL_H__
+#define __FLOODFILL_H__
+
+#include "../arena/arena.h"
+
+// Flood fills work on bitsets laid out like the arena bitplanes, wordsPerRow words per row
+uint64_t flood_fill_passable(arena_t *arena, uint32_t startX, uint32_t startY, uint64_t *reached);
+uint64_t count_passable(arena_t *arena);
+int32_t find_passable(arena_t *arena, uint32_t *x, uint32_t *y);
+
+#endif
@@ -0,0 +1,440 @@
+#include "./generator.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Directions follow the robot: 0 north, 1 east, 2 south, 3 west
+static const int32_t latticeX[4] = {0, 1, 0, -1};
+static const int32_t latticeY[4] = {-1, 0, 1, 0};
+
+typedef struct {
+    arena_t *arena;
+    uint32_t cellsX;
+    uint32_t cellsY;
+    uint32_t cellCount;
+} lattice_t;
+
+lattice_t create_lattice(arena_t *arena)
+{
+    lattice_t lattice = {arena, (arena->width + 1) / 2, (arena->height + 1) / 2, 0};
+    lattice.cellCount = lattice.cellsX * lattice.cellsY;
+    return lattice;
+}
+
+// Returns the neighbouring cell or UINT32_MAX at the edge of the lattice
+uint32_t lattice_neighbour(lattice_t *lattice, uint32_t cell, uint32_t direction)
+{
+    int64_t x = (int64_t)(cell % lattice->cellsX) + latticeX[direction];
+    int64_t y = (int64_t)(cell / lattice->cellsX) + latticeY[direction];
+    if (x < 0 || y < 0 || x >= lattice->cellsX || y >= lattice->cellsY)
+    {
+        return UINT32_MAX;
+    }
+    return y * lattice->cellsX + x;
+}
+
+void open_cell(lattice_t *lattice, uint32_t cell)
+{
+    set_empty_tile(lattice->arena, cell % lattice->cellsX * 2, cell / lattice->cellsX * 2);
+}
+
+// Opens the wall between a cell and its neighbour in the given direction, and the neighbour itself
+void open_passage(lattice_t *lattice, uint32_t cell, uint32_t direction)
+{
+    uint32_t x = cell % lattice->cellsX * 2;
+    uint32_t y = cell / lattice->cellsX * 2;
+    set_empty_tile(lattice->arena, x + latticeX[direction], y + latticeY[direction]);
+    set_empty_tile(lattice->arena, x + 2 * latticeX[direction], y + 2 * latticeY[direction]);
+}
+
+void fill_walls(arena_t *arena)
+{
+    for (uint32_t y = 0; y < arena->height; y++)
+    {
+        for (uint32_t x = 0; x < arena->width; x++)
+        {
+            set_obstacle_tile(arena, x, y);
+        }
+    }
+}
+
+// Depth first search with an explicit stack, long winding corridors with few dead ends
+int32_t generate_backtracker(lattice_t *lattice, prng_t *prng)
+{
+    uint32_t *stack = malloc(lattice->cellCount * sizeof(uint32_t));
+    uint8_t *visited = calloc(lattice->cellCount, sizeof(uint8_t));
+    if (!stack || !visited)
+    {
+        free(stack);
+        free(visited);
+        return 0;
+    }
+
+    uint32_t size = 0;
+    uint32_t start = prng_below(prng, lattice->cellCount);
+    open_cell(lattice, start);
+    visited[start] = 1;
+    stack[size++] = start;
+
+    while (size)
+    {
+        uint32_t cell = stack[size - 1];
+        uint32_t directions[4];
+        uint32_t count = 0;
+        for (uint32_t direction = 0; direction < 4; direction++)
+        {
+            uint32_t neighbour = lattice_neighbour(lattice, cell, direction);
+            if (neighbour != UINT32_MAX && !visited[neighbour])
+            {
+                directions[count++] = direction;
+            }
+        }
+
+        if (!count)
+        {
+            size--;
+            continue;
+        }
+
+        uint32_t direction = directions[prng_below(prng, count)];
+        uint32_t neighbour = lattice_neighbour(lattice, cell, direction);
+        open_passage(lattice, cell, direction);
+        visited[neighbour] = 1;
+        stack[size++] = neighbour;
+    }
+
+    free(stack);
+    free(visited);
+    return 1;
+}
+
+uint32_t lattice_find(uint32_t *parent, uint32_t cell)
+{
+    while (parent[cell] != cell)
+    {
+        parent[cell] = parent[parent[cell]];
+        cell = parent[cell];
+    }
+    return cell;
+}
+
+// Opens the walls in a random order whenever they join two cells that are not connected yet. Cells that already
+// share a set in parent, like the cells of one room, are never joined a second time.
+int32_t join_cells_randomly(lattice_t *lattice, uint32_t *parent, prng_t *prng)
+{
+    // wall 2 * cell is east of the cell, 2 * cell + 1 south of it
+    uint32_t *walls = malloc(2 * (size_t)lattice->cellCount * sizeof(uint32_t));
+    if (!walls)
+    {
+        return 0;
+    }
+
+    uint32_t wallCount = 0;
+    for (uint32_t cell = 0; cell < lattice->cellCount; cell++)
+    {
+        if (cell % lattice->cellsX + 1 < lattice->cellsX)
+        {
+            walls[wallCount++] = 2 * cell;
+        }
+        if (cell / lattice->cellsX + 1 < lattice->cellsY)
+        {
+            walls[wallCount++] = 2 * cell + 1;
+        }
+    }
+
+    for (uint32_t i = 0; i < wallCount; i++)
+    {
+        uint32_t pick = i + prng_below(prng, wallCount - i);
+        uint32_t wall = walls[pick];
+        walls[pick] = walls[i];
+
+        uint32_t cell = wall / 2;
+        uint32_t direction = wall % 2 ? 2 : 1;
+        uint32_t a = lattice_find(parent, cell);
+        uint32_t b = lattice_find(parent, lattice_neighbour(lattice, cell, direction));
+        if (a != b)
+        {
+            parent[a < b ? b : a] = a < b ? a : b;
+            open_passage(lattice, cell, direction);
+        }
+    }
+
+    free(walls);
+    return 1;
+}
+
+// Randomized Kruskal, many short dead ends
+int32_t generate_kruskal(lattice_t *lattice, prng_t *prng)
+{
+    uint32_t *parent = malloc(lattice->cellCount * sizeof(uint32_t));
+    if (!parent)
+    {
+        return 0;
+    }
+
+    for (uint32_t cell = 0; cell < lattice->cellCount; cell++)
+    {
+        parent[cell] = cell;
+        open_cell(lattice, cell);
+    }
+
+    int32_t result = join_cells_randomly(lattice, parent, prng);
+    free(parent);
+    return result;
+}
+
+// Loop-erased random walks towards the cells already in the maze, every spanning tree is equally likely
+int32_t generate_wilson(lattice_t *lattice, prng_t *prng)
+{
+    uint8_t *inMaze = calloc(lattice->cellCount, sizeof(uint8_t));
+    uint8_t *exits = malloc(lattice->cellCount * sizeof(uint8_t));
+    if (!inMaze || !exits)
+    {
+        free(inMaze);
+        free(exits);
+        return 0;
+    }
+
+    uint32_t root = prng_below(prng, lattice->cellCount);
+    inMaze[root] = 1;
+    open_cell(lattice, root);
+
+    for (uint32_t first = 0; first < lattice->cellCount; first++)
+    {
+        // walking over the cells again only overwrites their exit, which is what erases the loops
+        uint32_t cell = first;
+        while (!inMaze[cell])
+        {
+            uint32_t direction = prng_below(prng, 4);
+            uint32_t neighbour = lattice_neighbour(lattice, cell, direction);
+            if (neighbour == UINT32_MAX)
+            {
+                continue;
+            }
+
+            exits[cell] = direction;
+            cell = neighbour;
+        }
+
+        for (cell = first; !inMaze[cell]; cell = lattice_neighbour(lattice, cell, exits[cell]))
+        {
+            inMaze[cell] = 1;
+            open_cell(lattice, cell);
+            open_passage(lattice, cell, exits[cell]);
+        }
+    }
+
+    free(inMaze);
+    free(exits);
+    return 1;
+}
+
+// Rectangular rooms of whole cells that do not overlap, the corridors between them are a random spanning tree in
+// which every room counts as a single cell
+int32_t generate_rooms(lattice_t *lattice, prng_t *prng)
+{
+    uint32_t *parent = malloc(lattice->cellCount * sizeof(uint32_t));
+    uint8_t *inRoom = calloc(lattice->cellCount, sizeof(uint8_t));
+    if (!parent || !inRoom)
+    {
+        free(parent);
+        free(inRoom);
+        return 0;
+    }
+
+    for (uint32_t cell = 0; cell < lattice->cellCount; cell++)
+    {
+        parent[cell] = cell;
+        open_cell(lattice, cell);
+    }
+
+    uint32_t maxSideX = lattice->cellsX / 4 ? lattice->cellsX / 4 : 1;
+    uint32_t maxSideY = lattice->cellsY / 4 ? lattice->cellsY / 4 : 1;
+    for (uint32_t attempt = 0; attempt < GENERATOR_ROOM_ATTEMPTS; attempt++)
+    {
+        uint32_t sideX = prng_range(prng, 1, maxSideX);
+        uint32_t sideY = prng_range(prng, 1, maxSideY);
+        uint32_t left = prng_below(prng, lattice->cellsX - sideX + 1);
+        uint32_t top = prng_below(prng, lattice->cellsY - sideY + 1);
+
+        // rooms keep at least one wall between them so each stays a separate room
+        int32_t overlaps = 0;
+        for (uint32_t y = top ? top - 1 : 0; y < top + sideY + 1 && y < lattice->cellsY && !overlaps; y++)
+        {
+            for (uint32_t x = left ? left - 1 : 0; x < left + sideX + 1 && x < lattice->cellsX && !overlaps; x++)
+            {
+                overlaps = inRoom[y * lattice->cellsX + x];
+            }
+        }
+
+        if (overlaps)
+        {
+            continue;
+        }
+
+        uint32_t corner = top * lattice->cellsX + left;
+        for (uint32_t y = top; y < top + sideY; y++)
+        {
+            for (uint32_t x = left; x < left + sideX; x++)
+            {
+                inRoom[y * lattice->cellsX + x] = 1;
+                parent[y * lattice->cellsX + x] = corner;
+            }
+        }
+
+        for (uint32_t y = 2 * top; y <= 2 * (top + sideY - 1); y++)
+        {
+            for (uint32_t x = 2 * left; x <= 2 * (left + sideX - 1); x++)
+            {
+                set_empty_tile(lattice->arena, x, y);
+            }
+        }
+    }
+
+    int32_t result = join_cells_randomly(lattice, parent, prng);
+    free(parent);
+    free(inRoom);
+    return result;
+}
+
+// Turns an arena into a maze of the given type, the scatter type is placed by the maze module instead. Returns 0 if
+// the arena is unchanged or memory ran out half way.
+int32_t generate_arena(arena_t *arena, generator_type_t type, prng_t *prng)
+{
+    if (!validate_arena(arena) || !prng || type == GENERATOR_SCATTER || type > GENERATOR_ROOMS ||
+        (uint64_t)((arena->width + 1) / 2) * ((arena->height + 1) / 2) >= UINT32_MAX)
+    {
+        return 0;
+    }
+
+    lattice_t lattice = create_lattice(arena);
+    fill_walls(arena);
+    switch (type)
+    {
+        case GENERATOR_BACKTRACKER:
+            return generate_backtracker(&lattice, prng);
+        case GENERATOR_KRUSKAL:
+            return generate_kruskal(&lattice, prng);
+        case GENERATOR_WILSON:
+            return generate_wilson(&lattice, prng);
+        default:
+            return generate_rooms(&lattice, prng);
+    }
+}
+
+uint32_t find_row_set(uint32_t *parent, uint32_t set)
+{
+    while (parent[set] != set)
+    {
+        parent[set] = parent[parent[set]];
+        set = parent[set];
+    }
+    return set;
+}
+
+// Eller's algorithm. Every cell of the current row carries the set of cells it is already connected to through the
+// rows above. Neighbours in different sets are joined at random, the last row joins all of them, and every set
+// continues into the next row through at least one cell. A row never holds more sets than cells, so set ids stay
+// below cellsX and are reused once no cell carries them anymore.
+int32_t generate_streamed_maze(FILE *file, uint32_t width, uint32_t height, prng_t *prng)
+{
+    if (!file || !prng || !width || !height)
+    {
+        return 0;
+    }
+
+    uint32_t cellsX = width / 2 + width % 2;
+    uint32_t cellsY = height / 2 + height % 2;
+    size_t rowBytes = ((size_t)width + 7) / 8;
+    uint32_t *sets = malloc(cellsX * sizeof(uint32_t));
+    uint32_t *parent = malloc(cellsX * sizeof(uint32_t));
+    uint32_t *counts = malloc(cellsX * sizeof(uint32_t)); // cells of each set in the current row
+    uint8_t *down = malloc(cellsX * sizeof(uint8_t)); // cells that continue into the next row
+    uint8_t *setDown = malloc(cellsX * sizeof(uint8_t)); // sets that continue, the others free their id
+    uint8_t *row = malloc(rowBytes);
+    int32_t result = sets && parent && counts && down && setDown && row && fprintf(file, "%u %u\n", width, height) > 0;
+
+    for (uint32_t x = 0; result && x < cellsX; x++)
+    {
+        sets[x] = x;
+        parent[x] = x;
+    }
+
+    for (uint32_t cellY = 0; result && cellY < cellsY; cellY++)
+    {
+        int32_t lastRow = cellY + 1 == cellsY;
+        memset(row, 0, rowBytes);
+        for (uint32_t x = 0; x < cellsX; x++)
+        {
+            row[x / 4] |= 1 << (2 * x % 8);
+            if (x + 1 == cellsX)
+            {
+                break;
+            }
+
+            uint32_t a = find_row_set(parent, sets[x]);
+            uint32_t b = find_row_set(parent, sets[x + 1]);
+            if (a != b && (lastRow || prng_below(prng, 2)))
+            {
+                parent[b] = a;
+                row[x / 4] |= 1 << ((2 * x + 1) % 8);
+            }
+        }
+
+        for (uint32_t x = 0; x < cellsX; x++)
+        {
+            sets[x] = find_row_set(parent, sets[x]);
+        }
+
+        for (uint32_t set = 0; set < cellsX; set++)
+        {
+            parent[set] = set;
+            counts[set] = 0;
+            setDown[set] = 0;
+        }
+
+        result = fwrite(row, 1, rowBytes, file) == rowBytes;
+        if (!result || 2 * cellY + 1 == height)
+        {
+            break;
+        }
+
+        // an even height ends in a row of obstacles below the last cells
+        memset(row, 0, rowBytes);
+        for (uint32_t x = 0; x < cellsX && !lastRow; x++)
+        {
+            counts[sets[x]]++;
+        }
+
+        for (uint32_t x = 0; x < cellsX && !lastRow; x++)
+        {
+            uint32_t set = sets[x];
+            counts[set]--;
+            down[x] = prng_below(prng, 2) || (!counts[set] && !setDown[set]);
+            setDown[set] |= down[x];
+            row[x / 4] |= down[x] << (2 * x % 8);
+        }
+
+        result = fwrite(row, 1, rowBytes, file) == rowBytes;
+
+        uint32_t freeSet = 0;
+        for (uint32_t x = 0; x < cellsX && !lastRow; x++)
+        {
+            if (!down[x])
+            {
+                while (setDown[freeSet])
+                {
+                    freeSet++;
+                }
+                sets[x] = freeSet++;
+            }
+        }
+    }
+
+    free(sets);
+    free(parent);
+    free(counts);
+    free(down);
+    free(setDown);
+    free(row);
+    return result && fflush(file) == 0;
+}
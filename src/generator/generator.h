@@ -0,0 +1,28 @@
+#ifndef __GENERATOR_H__
+#define __GENERATOR_H__
+
+#include "../arena/arena.h"
+#include "../prng/prng.h"
+#include <stdio.h>
+
+#define GENERATOR_ROOM_ATTEMPTS 16
+
+typedef enum {
+    GENERATOR_SCATTER, // independent obstacles, each one checked against the connectivity of the rest
+    GENERATOR_BACKTRACKER,
+    GENERATOR_KRUSKAL,
+    GENERATOR_WILSON,
+    GENERATOR_ROOMS
+} generator_type_t;
+
+// The corridor generators work on a lattice of cells at even coordinates, the tiles between two cells are walls.
+// Every generator walls off the whole arena first and then opens a spanning tree of the cells, so the walkable
+// tiles are connected by construction and each cell is handled a constant number of times.
+int32_t generate_arena(arena_t *arena, generator_type_t type, prng_t *prng);
+
+// Writes a maze on the same lattice row by row without ever holding the arena, memory only grows with the width.
+// The file starts with a "width height" text line, every tile row follows as (width + 7) / 8 bytes in which bit
+// x % 8 of byte x / 8 is set when tile x is empty, the other tiles are obstacles.
+int32_t generate_streamed_maze(FILE *file, uint32_t width, uint32_t height, prng_t *prng);
+
+#endif
@@ -0,0 +1,656 @@
+#include "./hpa.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Implementation details inspired from Botea, Mueller and Schaeffer, "Near Optimal Hierarchical Path-Finding" (HPA*)
+
+uint32_t hpa_cluster_of(hpa_t *hpa, uint32_t x, uint32_t y)
+{
+    return (y / hpa->clusterSize) * hpa->clustersX + x / hpa->clusterSize;
+}
+
+void hpa_cluster_bounds(hpa_t *hpa, uint32_t cluster, uint32_t *minX, uint32_t *minY, uint32_t *maxX, uint32_t *maxY)
+{
+    *minX = (cluster % hpa->clustersX) * hpa->clusterSize;
+    *minY = (cluster / hpa->clustersX) * hpa->clusterSize;
+    *maxX = *minX + hpa->clusterSize - 1;
+    *maxY = *minY + hpa->clusterSize - 1;
+    if (*maxX >= hpa->pathfinder->width)
+    {
+        *maxX = hpa->pathfinder->width - 1;
+    }
+    if (*maxY >= hpa->pathfinder->height)
+    {
+        *maxY = hpa->pathfinder->height - 1;
+    }
+}
+
+hpa_t *create_hpa(pathfinder_t *pathfinder, uint32_t clusterSize)
+{
+    if (!pathfinder || clusterSize < 2)
+    {
+        return 0;
+    }
+
+    hpa_t *hpa = malloc(sizeof(hpa_t));
+    if (!hpa)
+    {
+        return 0;
+    }
+
+    memset(hpa, 0, sizeof(hpa_t));
+    hpa->pathfinder = pathfinder;
+    hpa->clusterSize = clusterSize;
+    hpa->clustersX = (pathfinder->width + clusterSize - 1) / clusterSize;
+    hpa->clustersY = (pathfinder->height + clusterSize - 1) / clusterSize;
+
+    uint32_t clusterCount = hpa->clustersX * hpa->clustersY;
+    hpa->clusters = calloc(clusterCount, sizeof(hpa_cluster_t));
+    hpa->eastBorders = calloc(clusterCount, sizeof(hpa_border_t));
+    hpa->southBorders = calloc(clusterCount, sizeof(hpa_border_t));
+    hpa->clusterOffsets = calloc(clusterCount + 1, sizeof(uint32_t));
+    if (!hpa->clusters || !hpa->eastBorders || !hpa->southBorders || !hpa->clusterOffsets)
+    {
+        dispose_hpa(hpa);
+        return 0;
+    }
+
+    // everything is built on the first query
+    for (uint32_t i = 0; i < clusterCount; i++)
+    {
+        hpa->clusters[i].dirty = 1;
+    }
+    hpa->hasDirty = 1;
+
+    return hpa;
+}
+
+void dispose_hpa(hpa_t *hpa)
+{
+    if (!hpa)
+    {
+        return;
+    }
+
+    uint32_t clusterCount = hpa->clustersX * hpa->clustersY;
+    for (uint32_t i = 0; i < clusterCount; i++)
+    {
+        if (hpa->clusters)
+        {
+            free(hpa->clusters[i].entrances);
+            free(hpa->clusters[i].distances);
+        }
+        if (hpa->eastBorders)
+        {
+            free(hpa->eastBorders[i].pairs);
+        }
+        if (hpa->southBorders)
+        {
+            free(hpa->southBorders[i].pairs);
+        }
+    }
+
+    free(hpa->clusters);
+    free(hpa->eastBorders);
+    free(hpa->southBorders);
+    free(hpa->clusterOffsets);
+    free(hpa->nodeCells);
+    free(hpa->g);
+    free(hpa->parent);
+    free(hpa->heapSlot);
+    free(hpa->stamp);
+    dispose_priority_queue(hpa->openList);
+    free(hpa);
+}
+
+void hpa_notify_tile_changed(hpa_t *hpa, uint32_t x, uint32_t y)
+{
+    if (!hpa || x >= hpa->pathfinder->width || y >= hpa->pathfinder->height)
+    {
+        return;
+    }
+
+    hpa->clusters[hpa_cluster_of(hpa, x, y)].dirty = 1;
+    hpa->hasDirty = 1;
+}
+
+void border_add(hpa_border_t *border, uint32_t first, uint32_t second)
+{
+    if (border->count == border->capacity)
+    {
+        uint32_t newCapacity = border->capacity ? border->capacity * 2 : 4;
+        uint32_t *newPairs = realloc(border->pairs, newCapacity * 2 * sizeof(uint32_t));
+        if (!newPairs)
+        {
+            return;
+        }
+        border->pairs = newPairs;
+        border->capacity = newCapacity;
+    }
+
+    border->pairs[border->count * 2] = first;
+    border->pairs[border->count * 2 + 1] = second;
+    border->count++;
+}
+
+// Scans the line of cell pairs (x, y) / (x + dx, y + dy) while stepping (stepX, stepY), every maximal run
+// of walkable pairs becomes one transition in its middle, or two at its ends when the run is long
+void build_border(hpa_t *hpa, hpa_border_t *border, uint32_t x, uint32_t y, int32_t dx, int32_t dy, int32_t stepX, int32_t stepY, uint32_t length)
+{
+    pathfinder_t *pathfinder = hpa->pathfinder;
+    border->count = 0;
+
+    uint32_t runStart = 0;
+    uint32_t runLength = 0;
+    for (uint32_t i = 0; i <= length; i++)
+    {
+        int32_t ax = x + stepX * i;
+        int32_t ay = y + stepY * i;
+        int32_t open = i < length && pf_is_walkable(pathfinder, ax, ay) && pf_is_walkable(pathfinder, ax + dx, ay + dy);
+        if (open)
+        {
+            if (runLength == 0)
+            {
+                runStart = i;
+            }
+            runLength++;
+            continue;
+        }
+
+        if (runLength == 0)
+        {
+            continue;
+        }
+
+        uint32_t picks[2] = {runStart + runLength / 2, 0};
+        uint32_t pickCount = 1;
+        if (runLength >= 6)
+        {
+            picks[0] = runStart;
+            picks[1] = runStart + runLength - 1;
+            pickCount = 2;
+        }
+
+        for (uint32_t p = 0; p < pickCount; p++)
+        {
+            uint32_t px = x + stepX * picks[p];
+            uint32_t py = y + stepY * picks[p];
+            border_add(border, arena_cell_index(pathfinder->arena, px, py), arena_cell_index(pathfinder->arena, px + dx, py + dy));
+        }
+        runLength = 0;
+    }
+}
+
+void build_cluster_borders(hpa_t *hpa, uint32_t cluster)
+{
+    uint32_t minX, minY, maxX, maxY;
+    hpa_cluster_bounds(hpa, cluster, &minX, &minY, &maxX, &maxY);
+
+    if (cluster % hpa->clustersX + 1 < hpa->clustersX)
+    {
+        build_border(hpa, &hpa->eastBorders[cluster], maxX, minY, 1, 0, 0, 1, maxY - minY + 1);
+    }
+
+    if (cluster / hpa->clustersX + 1 < hpa->clustersY)
+    {
+        build_border(hpa, &hpa->southBorders[cluster], minX, maxY, 0, 1, 1, 0, maxX - minX + 1);
+    }
+}
+
+void add_entrance(hpa_cluster_t *cluster, uint32_t cell, uint32_t capacity)
+{
+    for (uint32_t i = 0; i < cluster->entranceCount; i++)
+    {
+        if (cluster->entrances[i] == cell)
+        {
+            return;
+        }
+    }
+
+    if (cluster->entranceCount < capacity)
+    {
+        cluster->entrances[cluster->entranceCount++] = cell;
+    }
+}
+
+void rebuild_cluster_entrances(hpa_t *hpa, uint32_t index)
+{
+    hpa_cluster_t *cluster = &hpa->clusters[index];
+    hpa_border_t *east = &hpa->eastBorders[index];
+    hpa_border_t *south = &hpa->southBorders[index];
+    hpa_border_t *west = index % hpa->clustersX > 0 ? &hpa->eastBorders[index - 1] : 0;
+    hpa_border_t *north = index / hpa->clustersX > 0 ? &hpa->southBorders[index - hpa->clustersX] : 0;
+
+    uint32_t capacity = east->count + south->count + (west ? west->count : 0) + (north ? north->count : 0);
+
+    free(cluster->entrances);
+    free(cluster->distances);
+    cluster->entrances = 0;
+    cluster->distances = 0;
+    cluster->entranceCount = 0;
+    if (capacity == 0)
+    {
+        return;
+    }
+
+    cluster->entrances = malloc(capacity * sizeof(uint32_t));
+    if (!cluster->entrances)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < east->count; i++)
+    {
+        add_entrance(cluster, east->pairs[i * 2], capacity);
+    }
+    for (uint32_t i = 0; i < south->count; i++)
+    {
+        add_entrance(cluster, south->pairs[i * 2], capacity);
+    }
+    for (uint32_t i = 0; west && i < west->count; i++)
+    {
+        add_entrance(cluster, west->pairs[i * 2 + 1], capacity);
+    }
+    for (uint32_t i = 0; north && i < north->count; i++)
+    {
+        add_entrance(cluster, north->pairs[i * 2 + 1], capacity);
+    }
+
+    uint32_t count = cluster->entranceCount;
+    cluster->distances = malloc(count * count * sizeof(uint32_t));
+    if (!cluster->distances)
+    {
+        cluster->entranceCount = 0;
+        return;
+    }
+
+    uint32_t minX, minY, maxX, maxY;
+    hpa_cluster_bounds(hpa, index, &minX, &minY, &maxX, &maxY);
+    arena_t *arena = hpa->pathfinder->arena;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        pf_compute_bounded_distance_field(hpa->pathfinder, arena_cell_x(arena, cluster->entrances[i]), arena_cell_y(arena, cluster->entrances[i]), minX, minY, maxX, maxY);
+        for (uint32_t j = 0; j < count; j++)
+        {
+            cluster->distances[i * count + j] = pf_get_distance(hpa->pathfinder, arena_cell_x(arena, cluster->entrances[j]), arena_cell_y(arena, cluster->entrances[j]));
+        }
+    }
+}
+
+// Resizes the abstract search buffers to hold capacity nodes, their old contents are dropped
+int32_t resize_abstract_search(hpa_t *hpa, uint32_t capacity)
+{
+    free(hpa->nodeCells);
+    free(hpa->g);
+    free(hpa->parent);
+    free(hpa->heapSlot);
+    free(hpa->stamp);
+    dispose_priority_queue(hpa->openList);
+    hpa->openList = 0;
+
+    // stamps start zeroed and the generation starts at 1 so every node begins untouched
+    hpa->nodeCapacity = capacity;
+    hpa->generation = 1;
+    hpa->nodeCells = malloc(capacity * sizeof(uint32_t));
+    hpa->g = malloc(capacity * sizeof(uint32_t));
+    hpa->parent = malloc(capacity * sizeof(uint32_t));
+    hpa->heapSlot = malloc(capacity * sizeof(uint32_t));
+    hpa->stamp = calloc(capacity, sizeof(uint32_t));
+    if (hpa->heapSlot)
+    {
+        hpa->openList = create_priority_queue(PQ_BINARY_HEAP, capacity, hpa->heapSlot);
+    }
+
+    if (!hpa->nodeCells || !hpa->g || !hpa->parent || !hpa->heapSlot || !hpa->stamp || !hpa->openList)
+    {
+        hpa->nodeCapacity = 0;
+        return 0;
+    }
+
+    return 1;
+}
+
+// Numbers the entrances cluster by cluster and grows the abstract search to fit them plus the start and the goal
+int32_t number_entrances(hpa_t *hpa)
+{
+    uint32_t clusterCount = hpa->clustersX * hpa->clustersY;
+    uint32_t nodeCount = 0;
+    for (uint32_t i = 0; i < clusterCount; i++)
+    {
+        hpa->clusterOffsets[i] = nodeCount;
+        nodeCount += hpa->clusters[i].entranceCount;
+    }
+    hpa->clusterOffsets[clusterCount] = nodeCount;
+
+    if (nodeCount + 2 > hpa->nodeCapacity && !resize_abstract_search(hpa, nodeCount + 2))
+    {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < clusterCount; i++)
+    {
+        for (uint32_t j = 0; j < hpa->clusters[i].entranceCount; j++)
+        {
+            hpa->nodeCells[hpa->clusterOffsets[i] + j] = hpa->clusters[i].entrances[j];
+        }
+    }
+    hpa->nodeCount = nodeCount;
+    return 1;
+}
+
+// Rebuilds only the borders of clusters whose tiles changed and the entrances of the clusters touching those borders.
+// Returns 0 if the abstract search could not grow, the abstraction stays dirty so the next query tries again.
+int32_t hpa_refresh(hpa_t *hpa)
+{
+    if (!hpa->hasDirty)
+    {
+        return 1;
+    }
+
+    uint32_t clusterCount = hpa->clustersX * hpa->clustersY;
+    for (uint32_t i = 0; i < clusterCount; i++)
+    {
+        if (!hpa->clusters[i].dirty)
+        {
+            continue;
+        }
+
+        uint32_t column = i % hpa->clustersX;
+        uint32_t row = i / hpa->clustersX;
+
+        build_cluster_borders(hpa, i);
+        hpa->clusters[i].stale = 1;
+        if (column > 0)
+        {
+            build_cluster_borders(hpa, i - 1);
+            hpa->clusters[i - 1].stale = 1;
+        }
+        if (row > 0)
+        {
+            build_cluster_borders(hpa, i - hpa->clustersX);
+            hpa->clusters[i - hpa->clustersX].stale = 1;
+        }
+        if (column + 1 < hpa->clustersX)
+        {
+            hpa->clusters[i + 1].stale = 1;
+        }
+        if (row + 1 < hpa->clustersY)
+        {
+            hpa->clusters[i + hpa->clustersX].stale = 1;
+        }
+        hpa->clusters[i].dirty = 0;
+    }
+
+    for (uint32_t i = 0; i < clusterCount; i++)
+    {
+        if (hpa->clusters[i].stale)
+        {
+            rebuild_cluster_entrances(hpa, i);
+            hpa->clusters[i].stale = 0;
+        }
+    }
+
+    if (!number_entrances(hpa))
+    {
+        return 0;
+    }
+
+    hpa->hasDirty = 0;
+    return 1;
+}
+
+int32_t find_entrance(hpa_cluster_t *cluster, uint32_t cell)
+{
+    for (uint32_t i = 0; i < cluster->entranceCount; i++)
+    {
+        if (cluster->entrances[i] == cell)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+// Sets outOfMemory on the pathfinder when the open list cannot take the node, the search loop stops on it
+void abstract_relax(hpa_t *hpa, uint32_t current, uint32_t next, uint32_t cost, uint32_t goalX, uint32_t goalY)
+{
+    if (cost == PF_UNREACHABLE)
+    {
+        return;
+    }
+
+    int32_t visited = hpa->stamp[next] == hpa->generation;
+    if (visited && hpa->heapSlot[next] == PF_CLOSED)
+    {
+        return;
+    }
+
+    arena_t *arena = hpa->pathfinder->arena;
+    uint32_t g = hpa->g[current] + cost;
+    uint32_t f = g + heuristic(arena_cell_x(arena, hpa->nodeCells[next]), arena_cell_y(arena, hpa->nodeCells[next]), goalX, goalY);
+    if (!visited)
+    {
+        hpa->stamp[next] = hpa->generation;
+        hpa->g[next] = g;
+        hpa->parent[next] = current;
+        hpa->pathfinder->stats.heapOperations++;
+        hpa->pathfinder->outOfMemory |= !pq_push(hpa->openList, next, f, g);
+    }
+    else if (g < hpa->g[next])
+    {
+        hpa->g[next] = g;
+        hpa->parent[next] = current;
+        hpa->pathfinder->stats.heapOperations++;
+        hpa->pathfinder->outOfMemory |= !pq_decrease_key(hpa->openList, next, f, g);
+    }
+}
+
+// Relaxes the transitions of the entrance at cell towards the entrances of the neighbouring cluster across border
+void relax_transitions(hpa_t *hpa, hpa_border_t *border, uint32_t current, uint32_t cell, uint32_t side, uint32_t neighbor, uint32_t goalX, uint32_t goalY)
+{
+    for (uint32_t i = 0; border && i < border->count; i++)
+    {
+        if (border->pairs[i * 2 + side] == cell)
+        {
+            int32_t entrance = find_entrance(&hpa->clusters[neighbor], border->pairs[i * 2 + 1 - side]);
+            if (entrance >= 0)
+            {
+                abstract_relax(hpa, current, hpa->clusterOffsets[neighbor] + entrance, 1, goalX, goalY);
+            }
+        }
+    }
+}
+
+// Runs the bounded search for the segment between two cells of the same cluster and appends its cells after from
+uint32_t refine_segment(hpa_t *hpa, uint32_t from, uint32_t to, uint32_t *cells, uint32_t count)
+{
+    pathfinder_t *pathfinder = hpa->pathfinder;
+    arena_t *arena = pathfinder->arena;
+    if (heuristic(arena_cell_x(arena, from), arena_cell_y(arena, from), arena_cell_x(arena, to), arena_cell_y(arena, to)) == 1)
+    {
+        cells[count++] = to;
+        return count;
+    }
+
+    uint32_t minX, minY, maxX, maxY;
+    hpa_cluster_bounds(hpa, hpa_cluster_of(hpa, arena_cell_x(arena, from), arena_cell_y(arena, from)), &minX, &minY, &maxX, &maxY);
+    pf_compute_bounded_distance_field(pathfinder, arena_cell_x(arena, from), arena_cell_y(arena, from), minX, minY, maxX, maxY);
+
+    uint32_t length = pf_get_distance(pathfinder, arena_cell_x(arena, to), arena_cell_y(arena, to));
+    uint32_t cell = to;
+    for (uint32_t i = length; i > 0; i--)
+    {
+        cells[count + i - 1] = cell;
+        cell = pathfinder->parent[cell];
+    }
+
+    return count + length;
+}
+
+node_t *hpa_search(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint32_t goalX, uint32_t goalY)
+{
+    if (!pathfinder || startX >= pathfinder->width || startY >= pathfinder->height || goalX >= pathfinder->width || goalY >= pathfinder->height)
+    {
+        return 0;
+    }
+
+    pf_sync_changes(pathfinder);
+    if (!pathfinder->hpa)
+    {
+        pathfinder->hpa = create_hpa(pathfinder, HPA_CLUSTER_SIZE);
+        if (!pathfinder->hpa)
+        {
+            return 0;
+        }
+    }
+
+    hpa_t *hpa = pathfinder->hpa;
+    if (!hpa_refresh(hpa))
+    {
+        pathfinder->outOfMemory = 1;
+        return 0;
+    }
+
+    arena_t *arena = pathfinder->arena;
+    uint32_t startCell = arena_cell_index(arena, startX, startY);
+    uint32_t goalCell = arena_cell_index(arena, goalX, goalY);
+    uint32_t startIndex = hpa_cluster_of(hpa, startX, startY);
+    uint32_t goalIndex = hpa_cluster_of(hpa, goalX, goalY);
+    hpa_cluster_t *startCluster = &hpa->clusters[startIndex];
+    hpa_cluster_t *goalCluster = &hpa->clusters[goalIndex];
+
+    // connect the start and the goal to the entrances of their clusters
+    uint32_t *startDistances = malloc((startCluster->entranceCount + 1) * sizeof(uint32_t));
+    uint32_t *goalDistances = malloc((goalCluster->entranceCount + 1) * sizeof(uint32_t));
+    if (!startDistances || !goalDistances)
+    {
+        free(startDistances);
+        free(goalDistances);
+        return 0;
+    }
+
+    uint32_t minX, minY, maxX, maxY;
+    hpa_cluster_bounds(hpa, startIndex, &minX, &minY, &maxX, &maxY);
+    pf_compute_bounded_distance_field(pathfinder, startX, startY, minX, minY, maxX, maxY);
+    for (uint32_t i = 0; i < startCluster->entranceCount; i++)
+    {
+        startDistances[i] = pf_get_distance(pathfinder, arena_cell_x(arena, startCluster->entrances[i]), arena_cell_y(arena, startCluster->entrances[i]));
+    }
+    uint32_t directDistance = startIndex == goalIndex ? pf_get_distance(pathfinder, goalX, goalY) : PF_UNREACHABLE;
+
+    hpa_cluster_bounds(hpa, goalIndex, &minX, &minY, &maxX, &maxY);
+    pf_compute_bounded_distance_field(pathfinder, goalX, goalY, minX, minY, maxX, maxY);
+    for (uint32_t i = 0; i < goalCluster->entranceCount; i++)
+    {
+        goalDistances[i] = pf_get_distance(pathfinder, arena_cell_x(arena, goalCluster->entrances[i]), arena_cell_y(arena, goalCluster->entrances[i]));
+    }
+
+    // A* over the entrance graph, cells are only looked up for the heuristic and for the route that is refined
+    uint32_t startNode = hpa->nodeCount;
+    uint32_t goalNode = hpa->nodeCount + 1;
+    hpa->nodeCells[startNode] = startCell;
+    hpa->nodeCells[goalNode] = goalCell;
+    hpa->generation++;
+    if (hpa->generation == 0) // wrapped around, old stamps could collide with new generations
+    {
+        memset(hpa->stamp, 0, hpa->nodeCapacity * sizeof(uint32_t));
+        hpa->generation = 1;
+    }
+    pq_clear(hpa->openList);
+
+    hpa->stamp[startNode] = hpa->generation;
+    hpa->g[startNode] = 0;
+    hpa->parent[startNode] = PF_NO_PARENT;
+    pathfinder->stats.heapOperations++;
+    pathfinder->outOfMemory = !pq_push(hpa->openList, startNode, heuristic(startX, startY, goalX, goalY), 0);
+
+    int32_t found = 0;
+    while (!pq_is_empty(hpa->openList) && !pathfinder->outOfMemory)
+    {
+        uint32_t current = pq_pop(hpa->openList);
+        hpa->heapSlot[current] = PF_CLOSED;
+        pathfinder->stats.heapOperations++;
+        pathfinder->stats.expandedNodes++;
+
+        if (current == goalNode)
+        {
+            found = 1;
+            break;
+        }
+
+        if (current == startNode)
+        {
+            for (uint32_t i = 0; i < startCluster->entranceCount; i++)
+            {
+                abstract_relax(hpa, current, hpa->clusterOffsets[startIndex] + i, startDistances[i], goalX, goalY);
+            }
+            abstract_relax(hpa, current, goalNode, directDistance, goalX, goalY);
+            continue;
+        }
+
+        uint32_t cell = hpa->nodeCells[current];
+        uint32_t index = hpa_cluster_of(hpa, arena_cell_x(arena, cell), arena_cell_y(arena, cell));
+        hpa_cluster_t *cluster = &hpa->clusters[index];
+        uint32_t entrance = current - hpa->clusterOffsets[index];
+        for (uint32_t i = 0; i < cluster->entranceCount; i++)
+        {
+            if (i != entrance)
+            {
+                abstract_relax(hpa, current, hpa->clusterOffsets[index] + i, cluster->distances[entrance * cluster->entranceCount + i], goalX, goalY);
+            }
+        }
+
+        relax_transitions(hpa, &hpa->eastBorders[index], current, cell, 0, index + 1, goalX, goalY);
+        relax_transitions(hpa, &hpa->southBorders[index], current, cell, 0, index + hpa->clustersX, goalX, goalY);
+        relax_transitions(hpa, index % hpa->clustersX > 0 ? &hpa->eastBorders[index - 1] : 0, current, cell, 1, index - 1, goalX, goalY);
+        relax_transitions(hpa, index / hpa->clustersX > 0 ? &hpa->southBorders[index - hpa->clustersX] : 0, current, cell, 1, index - hpa->clustersX, goalX, goalY);
+
+        if (index == goalIndex)
+        {
+            abstract_relax(hpa, current, goalNode, goalDistances[entrance], goalX, goalY);
+        }
+    }
+
+    free(startDistances);
+    free(goalDistances);
+    if (!found)
+    {
+        return 0;
+    }
+
+    // refine only the abstract edges on the chosen route back into cells
+    uint32_t abstractCount = 1;
+    for (uint32_t node = goalNode; hpa->parent[node] != PF_NO_PARENT; node = hpa->parent[node])
+    {
+        abstractCount++;
+    }
+
+    uint32_t *route = malloc(abstractCount * sizeof(uint32_t));
+    uint32_t *cells = malloc((hpa->g[goalNode] + 1) * sizeof(uint32_t));
+    if (!route || !cells)
+    {
+        free(route);
+        free(cells);
+        return 0;
+    }
+
+    uint32_t node = goalNode;
+    for (int32_t i = abstractCount - 1; i >= 0; i--)
+    {
+        route[i] = hpa->nodeCells[node];
+        node = hpa->parent[node];
+    }
+
+    uint32_t count = 0;
+    cells[count++] = startCell;
+    for (uint32_t i = 0; i + 1 < abstractCount; i++)
+    {
+        count = refine_segment(hpa, route[i], route[i + 1], cells, count);
+    }
+
+    node_t *path = pf_build_path_from_cells(pathfinder, cells, count, goalX, goalY);
+    free(route);
+    free(cells);
+    return path;
+}
@@ -0,0 +1,56 @@
+#ifndef __HPA_H__
+#define __HPA_H__
+
+#include "../pathfinder/pathfinder.h"
+
+#define HPA_CLUSTER_SIZE 16
+
+// Transitions across one cluster border, pairs[2 * i] is on the west/north side and pairs[2 * i + 1] on the east/south side
+typedef struct {
+    uint32_t *pairs;
+    uint32_t count;
+    uint32_t capacity;
+} hpa_border_t;
+
+// Entrances are the cells of a cluster that take part in a transition, distances holds the walking
+// distance between every pair of them without leaving the cluster
+typedef struct {
+    uint32_t *entrances;
+    uint32_t entranceCount;
+    uint32_t *distances;
+    int32_t dirty; // tiles changed, the borders of this cluster need rebuilding
+    int32_t stale; // borders changed, entrances and distances need rebuilding
+} hpa_cluster_t;
+
+// Abstraction of an arena into square clusters for hierarchical path planning (HPA*)
+typedef struct hpa_t {
+    pathfinder_t *pathfinder;
+    uint32_t clusterSize;
+    uint32_t clustersX;
+    uint32_t clustersY;
+    hpa_cluster_t *clusters;
+    hpa_border_t *eastBorders;
+    hpa_border_t *southBorders;
+    int32_t hasDirty;
+
+    // The abstract search numbers the entrances of cluster i from clusterOffsets[i] on, the start and the goal of a
+    // query are the two nodes after the last entrance. Its buffers are indexed by these numbers like the ones of
+    // pathfinder_t are by cells, nodeCells maps a node back to its cell.
+    uint32_t *clusterOffsets;
+    uint32_t nodeCount;
+    uint32_t nodeCapacity;
+    uint32_t generation;
+    uint32_t *nodeCells;
+    uint32_t *g;
+    uint32_t *parent;
+    uint32_t *heapSlot;
+    uint32_t *stamp;
+    priority_queue_t *openList;
+} hpa_t;
+
+hpa_t *create_hpa(pathfinder_t *pathfinder, uint32_t clusterSize);
+void dispose_hpa(hpa_t *hpa);
+void hpa_notify_tile_changed(hpa_t *hpa, uint32_t x, uint32_t y);
+node_t *hpa_search(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint32_t goalX, uint32_t goalY);
+
+#endif
@@ -0,0 +1,170 @@
+#include "./jps.h"
+#include <stdlib.h>
+
+// Jump point search for 4-connected uniform-cost grids.
+// Idea for the 4-connected pruning rules from https://github.com/qiao/PathFinding.js (JumpPointFinderNeverMoveDiagonally)
+
+// Walks from (x, y) in direction (dx, dy) and returns the first jump point, or PF_NO_PARENT if there is none.
+// Horizontal jumps stop at forced neighbors, vertical jumps also stop wherever a horizontal jump would succeed.
+uint32_t jps_jump(pathfinder_t *pathfinder, int32_t x, int32_t y, int32_t dx, int32_t dy, uint32_t goalX, uint32_t goalY)
+{
+    while (pf_is_walkable(pathfinder, x, y))
+    {
+        uint32_t cell = arena_cell_index(pathfinder->arena, x, y);
+        if (x == goalX && y == goalY)
+        {
+            return cell;
+        }
+
+        if (dx != 0)
+        {
+            if ((pf_is_walkable(pathfinder, x, y - 1) && !pf_is_walkable(pathfinder, x - dx, y - 1)) ||
+                (pf_is_walkable(pathfinder, x, y + 1) && !pf_is_walkable(pathfinder, x - dx, y + 1)))
+            {
+                return cell;
+            }
+        }
+        else
+        {
+            if ((pf_is_walkable(pathfinder, x - 1, y) && !pf_is_walkable(pathfinder, x - 1, y - dy)) ||
+                (pf_is_walkable(pathfinder, x + 1, y) && !pf_is_walkable(pathfinder, x + 1, y - dy)))
+            {
+                return cell;
+            }
+
+            if (jps_jump(pathfinder, x + 1, y, 1, 0, goalX, goalY) != PF_NO_PARENT ||
+                jps_jump(pathfinder, x - 1, y, -1, 0, goalX, goalY) != PF_NO_PARENT)
+            {
+                return cell;
+            }
+        }
+
+        x += dx;
+        y += dy;
+    }
+
+    return PF_NO_PARENT;
+}
+
+// Fills directions with the pruned set of directions to explore from cell, returns how many there are
+uint32_t jps_prune_directions(pathfinder_t *pathfinder, uint32_t cell, int32_t directions[4][2])
+{
+    int32_t x = arena_cell_x(pathfinder->arena, cell);
+    int32_t y = arena_cell_y(pathfinder->arena, cell);
+    uint32_t count = 0;
+
+    if (pathfinder->parent[cell] == PF_NO_PARENT)
+    {
+        int32_t all[4][2] = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+        for (int32_t i = 0; i < 4; i++)
+        {
+            directions[count][0] = all[i][0];
+            directions[count][1] = all[i][1];
+            count++;
+        }
+        return count;
+    }
+
+    int32_t parentX = arena_cell_x(pathfinder->arena, pathfinder->parent[cell]);
+    int32_t parentY = arena_cell_y(pathfinder->arena, pathfinder->parent[cell]);
+    int32_t dx = (x > parentX) - (x < parentX);
+    int32_t dy = (y > parentY) - (y < parentY);
+
+    // keep going straight and always allow turning to either side, jps_jump rejects blocked directions
+    int32_t pruned[3][2] = {{dx, dy}, {dy, dx}, {-dy, -dx}};
+    for (int32_t i = 0; i < 3; i++)
+    {
+        directions[count][0] = pruned[i][0];
+        directions[count][1] = pruned[i][1];
+        count++;
+    }
+
+    return count;
+}
+
+node_t *jps_search(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint32_t goalX, uint32_t goalY)
+{
+    if (!pathfinder || startX >= pathfinder->width || startY >= pathfinder->height || goalX >= pathfinder->width || goalY >= pathfinder->height)
+    {
+        return 0;
+    }
+
+    pf_begin_query(pathfinder);
+
+    uint32_t startCell = arena_cell_index(pathfinder->arena, startX, startY);
+    uint32_t goalCell = arena_cell_index(pathfinder->arena, goalX, goalY);
+
+    pathfinder->stamp[startCell] = pathfinder->generation;
+    pathfinder->g[startCell] = 0;
+    pathfinder->parent[startCell] = PF_NO_PARENT;
+    pathfinder->stats.heapOperations++;
+    if (!pq_push(pathfinder->openList, startCell, heuristic(startX, startY, goalX, goalY), 0))
+    {
+        pathfinder->outOfMemory = 1;
+        return 0;
+    }
+
+    while (!pq_is_empty(pathfinder->openList))
+    {
+        uint32_t current = pq_pop(pathfinder->openList);
+        pathfinder->heapSlot[current] = PF_CLOSED;
+        pathfinder->stats.heapOperations++;
+        pathfinder->stats.expandedNodes++;
+
+        if (current == goalCell)
+        {
+            return pf_build_path(pathfinder, goalCell, goalX, goalY);
+        }
+
+        int32_t x = arena_cell_x(pathfinder->arena, current);
+        int32_t y = arena_cell_y(pathfinder->arena, current);
+
+        int32_t directions[4][2];
+        uint32_t directionCount = jps_prune_directions(pathfinder, current, directions);
+        for (uint32_t i = 0; i < directionCount; i++)
+        {
+            uint32_t jumpPoint = jps_jump(pathfinder, x + directions[i][0], y + directions[i][1], directions[i][0], directions[i][1], goalX, goalY);
+            if (jumpPoint == PF_NO_PARENT)
+            {
+                continue;
+            }
+
+            int32_t visited = pf_is_visited(pathfinder, jumpPoint);
+            if (visited && pathfinder->heapSlot[jumpPoint] == PF_CLOSED)
+            {
+                continue;
+            }
+
+            uint32_t jumpX = arena_cell_x(pathfinder->arena, jumpPoint);
+            uint32_t jumpY = arena_cell_y(pathfinder->arena, jumpPoint);
+            uint32_t g = pathfinder->g[current] + heuristic(x, y, jumpX, jumpY);
+            uint32_t f = g + heuristic(jumpX, jumpY, goalX, goalY);
+
+            if (!visited)
+            {
+                pathfinder->stamp[jumpPoint] = pathfinder->generation;
+                pathfinder->g[jumpPoint] = g;
+                pathfinder->parent[jumpPoint] = current;
+                pathfinder->stats.heapOperations++;
+                if (!pq_push(pathfinder->openList, jumpPoint, f, g))
+                {
+                    pathfinder->outOfMemory = 1;
+                    return 0;
+                }
+            }
+            else if (g < pathfinder->g[jumpPoint])
+            {
+                pathfinder->g[jumpPoint] = g;
+                pathfinder->parent[jumpPoint] = current;
+                pathfinder->stats.heapOperations++;
+                if (!pq_decrease_key(pathfinder->openList, jumpPoint, f, g))
+                {
+                    pathfinder->outOfMemory = 1;
+                    return 0;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
@@ -1,71 +1,338 @@
 #include "./defaults.h"
 #include "./maze/maze.h"
+#include "./pathcache/pathcache.h"
+#include "./components/components.h"
+#include "./turnplanner/turnplanner.h"
+#include "./batch/batch.h"
 #include <stdio.h>
 #include <limits.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
 
-int interpret_argv(int argc, char **argv)
+typedef struct {
+    int mode; // 0 is random, 1 is file, 2 streams a maze into a file, 3 generates a batch of mazes
+    char *filename;
+    uint32_t streamWidth;
+    uint32_t streamHeight;
+    uint32_t batchCount;
+    uint32_t threadCount;
+    char *outputDirectory;
+    pathfinder_mode_t searchMode;
+    priority_queue_type_t queueType;
+    arena_layout_t arenaLayout;
+    int greedy;
+    int noCache;
+    uint32_t forwardCost;
+    uint32_t turnCost;
+    int printStatistics;
+    int benchmarkQueues;
+    uint64_t seed; // seeds random generation, the current time unless given with -seed
+    generator_type_t generator;
+} program_options_t;
+
+void print_help(char *program)
+{
+    printf("%s -random          : generates random maze and solves it\n", program);
+    printf("%s -file <filename> : generates maze from filename and solves it\n", program);
+    printf("%s -stream <width> <height> <filename> : writes a maze of any size into filename without holding it in memory\n", program);
+    printf("%s -generate <n> -out <directory> : writes n random mazes into an existing directory in the -file format\n", program);
+    printf("%s -help            : displays this message\n", program);
+    printf("options:\n");
+    printf("  -search <astar|jps|turns|hpa|dstar|bidir> : search algorithm used to plan paths, defaults to astar\n");
+    printf("  -forwardcost <n>    : cost of one forward move for -search turns, defaults to 1\n");
+    printf("  -turncost <n>       : cost of one quarter turn for -search turns, defaults to 1\n");
+    printf("  -queue <binary|bucket|radix> : open list implementation, defaults to binary\n");
+    printf("  -layout <rows|tiled|sparse|bordered> : arena storage, tiled keeps 8x8 blocks together, sparse allocates 64x64 chunks on demand, bordered adds a sentinel ring, defaults to rows\n");
+    printf("  -greedy             : always walks to the nearest marker instead of planning a tour\n");
+    printf("  -nocache            : plans every path again instead of reusing cached ones\n");
+    printf("  -generator <scatter|backtracker|kruskal|wilson|rooms> : how -random lays out walls, every one but scatter carves a maze that is connected by construction, defaults to scatter\n");
+    printf("  -threads <n>        : threads -generate uses, defaults to %d\n", BATCH_THREAD_COUNT);
+    printf("  -seed <n>           : seed for -random, the same seed always generates the same maze, defaults to the current time\n");
+    printf("  -stats              : prints search statistics to stderr after solving\n");
+    printf("  -benchqueue         : times the searches of the maze with every -queue instead of solving it\n");
+}
+
+// Positive numbers that fit 32 bits, like arena sides and counts
+int parse_positive(char *text, uint32_t *value)
 {
-    // 0 is random
-    // 1 is file
-    int mode = 0;
-    char *filename = 0;
-    if (argc == 1)
+    char *end = 0;
+    unsigned long long parsed = strtoull(text, &end, 0);
+    if (text[0] == '-' || *end != '\0' || parsed == 0 || parsed > UINT32_MAX)
     {
-        mode = 0;
+        return 0;
     }
-    else if (argc == 2)
+
+    *value = (uint32_t)parsed;
+    return 1;
+}
+
+int interpret_argv(int argc, char **argv, program_options_t *options)
+{
+    memset(options, 0, sizeof(program_options_t));
+    options->mode = 0;
+    options->searchMode = PF_MODE_ASTAR;
+    options->queueType = PQ_BINARY_HEAP;
+    options->arenaLayout = ARENA_LAYOUT_ROW_MAJOR;
+    options->generator = GENERATOR_SCATTER;
+    options->threadCount = BATCH_THREAD_COUNT;
+    options->forwardCost = 1;
+    options->turnCost = 1;
+    options->seed = (uint64_t)time(0);
+
+    for (int i = 1; i < argc; i++)
     {
-        if (strcmp(argv[1], "-random") == 0)
+        if (strcmp(argv[i], "-random") == 0)
         {
-            mode = 0;
+            options->mode = 0;
         }
-        else if (strcmp(argv[1], "-file") == 0)
+        else if (strcmp(argv[i], "-file") == 0)
         {
-            printf("Missing file name\n");
-            return -1;
+            if (i + 1 >= argc)
+            {
+                printf("Missing file name\n");
+                return -1;
+            }
+
+            options->mode = 1;
+            options->filename = argv[++i];
+            FILE *file = fopen(options->filename, "r");
+            if (file == 0)
+            {
+                printf("Invalid file or filename.\n");
+                return -1;
+            }
+            fclose(file);
         }
-        else if (strcmp(argv[1], "-help") == 0)
+        else if (strcmp(argv[i], "-stream") == 0)
         {
-            printf("%s -random          : generates random maze and solves it\n", argv[0]);
-            printf("%s -file <filename> : generates maze from filename and solves it\n", argv[0]);
-            printf("%s -help            : displays thsi message\n", argv[0]);
-            return -1;
+            if (i + 3 >= argc || !parse_positive(argv[i + 1], &options->streamWidth) || !parse_positive(argv[i + 2], &options->streamHeight))
+            {
+                printf("-stream needs a positive width and height and a file name\n");
+                return -1;
+            }
+
+            options->mode = 2;
+            options->filename = argv[i + 3];
+            i += 3;
         }
-        else
+        else if (strcmp(argv[i], "-generate") == 0)
         {
-            printf("Invalid option: %s\n", argv[1]);
-            return -1;
+            if (i + 1 >= argc || !parse_positive(argv[i + 1], &options->batchCount))
+            {
+                printf("-generate needs a positive number of mazes\n");
+                return -1;
+            }
+
+            options->mode = 3;
+            i++;
         }
-    }
-    else if (argc == 3)
-    {
-        if (strcmp(argv[1], "-file") == 0)
+        else if (strcmp(argv[i], "-out") == 0)
         {
-            mode = 1;
-            filename = argv[2];
-            FILE *file = fopen(filename, "r");
-            if (file == 0)
+            if (i + 1 >= argc)
             {
-                printf("Invalid file or filename.\n");
+                printf("Missing output directory\n");
+                return -1;
+            }
+
+            options->outputDirectory = argv[++i];
+        }
+        else if (strcmp(argv[i], "-threads") == 0)
+        {
+            if (i + 1 >= argc || !parse_positive(argv[i + 1], &options->threadCount))
+            {
+                printf("-threads needs a positive number\n");
+                return -1;
+            }
+            i++;
+        }
+        else if (strcmp(argv[i], "-search") == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                printf("Missing search algorithm\n");
+                return -1;
+            }
+
+            i++;
+            if (strcmp(argv[i], "astar") == 0)
+            {
+                options->searchMode = PF_MODE_ASTAR;
+            }
+            else if (strcmp(argv[i], "jps") == 0)
+            {
+                options->searchMode = PF_MODE_JPS;
+            }
+            else if (strcmp(argv[i], "turns") == 0)
+            {
+                options->searchMode = PF_MODE_TURN_AWARE;
+            }
+            else if (strcmp(argv[i], "hpa") == 0)
+            {
+                options->searchMode = PF_MODE_HPA;
+            }
+            else if (strcmp(argv[i], "dstar") == 0)
+            {
+                options->searchMode = PF_MODE_DSTAR_LITE;
+            }
+            else if (strcmp(argv[i], "bidir") == 0)
+            {
+                options->searchMode = PF_MODE_BIDIRECTIONAL;
+            }
+            else
+            {
+                printf("Invalid search algorithm: %s\n", argv[i]);
+                return -1;
+            }
+        }
+        else if (strcmp(argv[i], "-queue") == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                printf("Missing queue type\n");
+                return -1;
+            }
+
+            i++;
+            if (strcmp(argv[i], "binary") == 0)
+            {
+                options->queueType = PQ_BINARY_HEAP;
+            }
+            else if (strcmp(argv[i], "bucket") == 0)
+            {
+                options->queueType = PQ_BUCKET_QUEUE;
+            }
+            else if (strcmp(argv[i], "radix") == 0)
+            {
+                options->queueType = PQ_RADIX_HEAP;
+            }
+            else
+            {
+                printf("Invalid queue type: %s\n", argv[i]);
+                return -1;
+            }
+        }
+        else if (strcmp(argv[i], "-layout") == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                printf("Missing arena layout\n");
+                return -1;
+            }
+
+            i++;
+            if (strcmp(argv[i], "rows") == 0)
+            {
+                options->arenaLayout = ARENA_LAYOUT_ROW_MAJOR;
+            }
+            else if (strcmp(argv[i], "tiled") == 0)
+            {
+                options->arenaLayout = ARENA_LAYOUT_TILED;
+            }
+            else if (strcmp(argv[i], "sparse") == 0)
+            {
+                options->arenaLayout = ARENA_LAYOUT_SPARSE;
+            }
+            else if (strcmp(argv[i], "bordered") == 0)
+            {
+                options->arenaLayout = ARENA_LAYOUT_BORDERED;
+            }
+            else
+            {
+                printf("Invalid arena layout: %s\n", argv[i]);
                 return -1;
             }
-            fclose(file);
+        }
+        else if (strcmp(argv[i], "-generator") == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                printf("Missing maze generator\n");
+                return -1;
+            }
+
+            i++;
+            if (strcmp(argv[i], "scatter") == 0)
+            {
+                options->generator = GENERATOR_SCATTER;
+            }
+            else if (strcmp(argv[i], "backtracker") == 0)
+            {
+                options->generator = GENERATOR_BACKTRACKER;
+            }
+            else if (strcmp(argv[i], "kruskal") == 0)
+            {
+                options->generator = GENERATOR_KRUSKAL;
+            }
+            else if (strcmp(argv[i], "wilson") == 0)
+            {
+                options->generator = GENERATOR_WILSON;
+            }
+            else if (strcmp(argv[i], "rooms") == 0)
+            {
+                options->generator = GENERATOR_ROOMS;
+            }
+            else
+            {
+                printf("Invalid maze generator: %s\n", argv[i]);
+                return -1;
+            }
+        }
+        else if (strcmp(argv[i], "-forwardcost") == 0 || strcmp(argv[i], "-turncost") == 0)
+        {
+            uint32_t *cost = strcmp(argv[i], "-forwardcost") == 0 ? &options->forwardCost : &options->turnCost;
+            if (i + 1 >= argc || !parse_positive(argv[i + 1], cost))
+            {
+                printf("%s needs a positive cost\n", argv[i]);
+                return -1;
+            }
+            i++;
+        }
+        else if (strcmp(argv[i], "-seed") == 0)
+        {
+            char *end = 0;
+            if (i + 1 >= argc || argv[i + 1][0] == '-' || (options->seed = strtoull(argv[i + 1], &end, 0), *end != '\0'))
+            {
+                printf("-seed needs a non-negative number\n");
+                return -1;
+            }
+            i++;
+        }
+        else if (strcmp(argv[i], "-greedy") == 0)
+        {
+            options->greedy = 1;
+        }
+        else if (strcmp(argv[i], "-nocache") == 0)
+        {
+            options->noCache = 1;
+        }
+        else if (strcmp(argv[i], "-stats") == 0)
+        {
+            options->printStatistics = 1;
+        }
+        else if (strcmp(argv[i], "-benchqueue") == 0)
+        {
+            options->benchmarkQueues = 1;
+        }
+        else if (strcmp(argv[i], "-help") == 0)
+        {
+            print_help(argv[0]);
+            return -1;
         }
         else
         {
-            printf("Invalid option: %s\n", argv[1]);
+            printf("Invalid option: %s, use -help for commands\n", argv[i]);
             return -1;
         }
     }
-    else
+
+    if (options->mode == 3 && !options->outputDirectory)
     {
-        printf("Invalid usage: use -help for commands\n");
+        printf("-generate needs an output directory given with -out\n");
         return -1;
     }
 
-    return mode;
+    return options->mode;
 }
 
 maze_settings_t read_settings_from_file(char *filename)
@@ -132,13 +399,15 @@ maze_settings_t read_settings_from_file(char *filename)
     return settings;
 }
 
-maze_settings_t get_settings(int mode, char *filename)
+maze_settings_t get_settings(int mode, char *filename, uint64_t seed, generator_type_t generator)
 {
     maze_settings_t settings = {0};
 
     if (mode == 0)
     {
-        settings = generate_random_maze(MIN_WIDTH, MAX_WIDTH, MIN_HEIGHT, MAX_HEIGHT, PADDING_SIZE, BACKGROUND_COLOR, PIXEL_PER_SIDE, MAX_OBSTACLE_AREA_PERCENTAGE, MAX_MARKER_AREA_PERCENTAGE, ROBOT_BORDER_COLOR, ROBOT_FILL_COLOR);
+        prng_t prng;
+        prng_seed(&prng, seed);
+        settings = generate_random_maze(&prng, generator, MIN_WIDTH, MAX_WIDTH, MIN_HEIGHT, MAX_HEIGHT, PADDING_SIZE, BACKGROUND_COLOR, PIXEL_PER_SIDE, MAX_OBSTACLE_AREA_PERCENTAGE, MAX_MARKER_AREA_PERCENTAGE, ROBOT_BORDER_COLOR, ROBOT_FILL_COLOR);
     }
     else if (mode == 1)
     {
@@ -167,18 +436,119 @@ maze_settings_t get_settings(int mode, char *filename)
     return settings;
 }
 
+// The maze never exists in memory, so it is written and neither drawn nor solved
+int stream_maze(program_options_t *options)
+{
+    FILE *file = fopen(options->filename, "wb");
+    if (file == 0)
+    {
+        printf("Invalid file or filename.\n");
+        return 0;
+    }
+
+    prng_t prng;
+    prng_seed(&prng, options->seed);
+    int32_t written = generate_streamed_maze(file, options->streamWidth, options->streamHeight, &prng);
+    if (fclose(file) != 0 || !written)
+    {
+        printf("Could not write the maze to %s.\n", options->filename);
+        return 0;
+    }
+
+    if (options->printStatistics)
+    {
+        fprintf(stderr, "seed: %llu\n", (unsigned long long)options->seed);
+    }
+    return 0;
+}
+
+int generate_batch(program_options_t *options)
+{
+    maze_batch_t *batch = create_maze_batch(options->outputDirectory, options->batchCount, options->threadCount, options->seed, options->generator);
+    if (!batch)
+    {
+        printf("Internal error.\n");
+        return 0;
+    }
+
+    run_maze_batch(batch);
+    printf("Generated %u mazes in %.3f s, %.1f mazes/s\n", batch->written, batch->seconds, batch->seconds > 0 ? batch->written / batch->seconds : 0.0);
+    if (batch->failed)
+    {
+        printf("%u mazes could not be written to %s.\n", batch->failed, options->outputDirectory);
+    }
+
+    if (options->printStatistics)
+    {
+        fprintf(stderr, "seed: %llu\n", (unsigned long long)options->seed);
+    }
+
+    dispose_maze_batch(batch);
+    return 0;
+}
+
+// Repeats the searches from the robot's start to every marker and home with each open list, so the fastest
+// queue can be picked per kind of map. The path cache is off, otherwise only the first round would search.
+void benchmark_queues(maze_t *maze)
+{
+    static const char *queueNames[] = {"binary", "bucket", "radix"};
+    pathfinder_t *pathfinder = maze->pathfinder;
+    robot_t *robot = maze->robot;
+    if (!pf_set_cache(pathfinder, 0, 0))
+    {
+        printf("Internal error.\n");
+        return;
+    }
+
+    for (int type = PQ_BINARY_HEAP; type <= PQ_RADIX_HEAP; type++)
+    {
+        if (!pf_set_queue_type(pathfinder, type))
+        {
+            printf("Internal error.\n");
+            return;
+        }
+
+        pathfinder->stats = (pathfinder_stats_t){0};
+        uint32_t searchCount = 0;
+        clock_t start = clock();
+        for (uint32_t round = 0; round < QUEUE_BENCHMARK_ROUNDS; round++)
+        {
+            for (uint32_t i = 0; i <= maze->settings.markerCount; i++)
+            {
+                uint32_t goalX = i < maze->settings.markerCount ? maze->settings.markersX[i] : robot->homeTileX;
+                uint32_t goalY = i < maze->settings.markerCount ? maze->settings.markersY[i] : robot->homeTileY;
+                free_path(pf_find_path(pathfinder, robot->x, robot->y, robot->direction, goalX, goalY));
+                searchCount++;
+            }
+        }
+
+        double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+        double operations = (double)pathfinder->stats.heapOperations;
+        printf("%-6s queue: %u searches in %.3f s, %llu heap operations, %.1f million operations/s\n", queueNames[type], searchCount, seconds, (unsigned long long)pathfinder->stats.heapOperations, seconds > 0 ? operations / seconds / 1e6 : 0.0);
+    }
+}
+
 int main(int argc, char **argv)
 {
-    // Get input mode
-    int mode = interpret_argv(argc, argv);
-    char *filename = 0; // input file name if any
+    // Get input mode and options
+    program_options_t options;
+    if (interpret_argv(argc, argv, &options) < 0)
+    {
+        return 0;
+    }
 
-    if (mode == 1)
+    if (options.mode == 2)
     {
-        filename = argv[2];
+        return stream_maze(&options);
     }
 
-    maze_settings_t settings = get_settings(mode, filename);
+    if (options.mode == 3)
+    {
+        return generate_batch(&options);
+    }
+
+    maze_settings_t settings = get_settings(options.mode, options.filename, options.seed, options.generator);
+    settings.arenaLayout = options.arenaLayout;
     maze_t *maze = create_maze(settings);
     if (!validate_maze(maze))
     {
@@ -186,8 +556,58 @@ int main(int argc, char **argv)
         return 0;
     }
 
+    maze->pathfinder->mode = options.searchMode;
+    maze->pathfinder->forwardCost = options.forwardCost;
+    maze->pathfinder->turnCost = options.turnCost;
+    maze->planTour = !options.greedy;
+    uint32_t maxCost = turn_max_action_cost(maze->pathfinder);
+    if (options.searchMode == PF_MODE_TURN_AWARE && (options.forwardCost > maxCost || options.turnCost > maxCost))
+    {
+        printf("-forwardcost and -turncost can be at most %u on this maze\n", maxCost);
+        dispose_maze(maze);
+        return 0;
+    }
+    if (!pf_set_queue_type(maze->pathfinder, options.queueType) || (options.noCache && !pf_set_cache(maze->pathfinder, 0, 0)))
+    {
+        printf("Internal error.\n");
+        dispose_maze(maze);
+        return 0;
+    }
+
+    if (options.benchmarkQueues)
+    {
+        benchmark_queues(maze);
+        dispose_maze(maze);
+        return 0;
+    }
+
     solve_maze(maze);
+
+    if (options.printStatistics)
+    {
+        if (options.mode == 0)
+        {
+            fprintf(stderr, "seed: %llu\n", (unsigned long long)options.seed);
+        }
+        fprintf(stderr, "expanded nodes: %llu\n", (unsigned long long)maze->pathfinder->stats.expandedNodes);
+        fprintf(stderr, "heap operations: %llu\n", (unsigned long long)maze->pathfinder->stats.heapOperations);
+        fprintf(stderr, "robot actions: %u moves, %u turns\n", maze->moveCount, maze->turnCount);
+        if (maze->pathfinder->cache)
+        {
+            path_cache_t *cache = maze->pathfinder->cache;
+            fprintf(stderr, "path cache: %llu hits, %llu misses, %llu evictions\n", (unsigned long long)cache->hits, (unsigned long long)cache->misses, (unsigned long long)cache->evictions);
+        }
+        if (maze->planTour)
+        {
+            fprintf(stderr, "planned tour length: %u (greedy: %u)\n", maze->plannedTourLength, maze->greedyTourLength);
+        }
+        if (maze->pathfinder->components)
+        {
+            fprintf(stderr, "walkable regions: %u\n", component_count(maze->pathfinder->components));
+        }
+    }
+
     dispose_maze(maze);
 
     return 0;
-}
\ No newline at end of file
+}
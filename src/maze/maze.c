@@ -1,10 +1,12 @@
 #include "./maze.h"
 #include "../pathfinder/pathfinder.h"
+#include "../tourplanner/tourplanner.h"
+#include "../pathcache/pathcache.h"
+#include "../floodfill/floodfill.h"
+#include "../connectivity/connectivity.h"
 #include "../graphics/graphics.h"
-#include "../queue/queue.h"
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
 #include <stdio.h>
 #include <limits.h>
 
@@ -78,7 +80,7 @@ maze_t *create_maze(maze_settings_t settings)
 
     memset(maze, 0, sizeof(maze_t));
 
-    arena_t *mainArena = create_arena(settings.width, settings.height);
+    arena_t *mainArena = create_arena_with_layout(settings.width, settings.height, settings.arenaLayout);
     if (!mainArena)
     {
         free(maze);
@@ -87,6 +89,17 @@ maze_t *create_maze(maze_settings_t settings)
 
     maze->arena = mainArena;
 
+    pathfinder_t *mainPathfinder = create_pathfinder(mainArena);
+    if (!mainPathfinder)
+    {
+        dispose_arena(mainArena);
+        free(maze);
+        return 0;
+    }
+
+    maze->pathfinder = mainPathfinder;
+    pf_set_cache(mainPathfinder, PATH_CACHE_DEFAULT_ENTRIES, PATH_CACHE_DEFAULT_BYTES);
+
     for (uint32_t i = 0; i < settings.markerCount; i++)
     {
         set_marker_tile(mainArena, settings.markersX[i], settings.markersY[i]);
@@ -109,6 +122,7 @@ maze_t *create_maze(maze_settings_t settings)
     robot_t *mainRobot = create_robot(mainArena, settings.robotHomeX, settings.robotHomeY, settings.robotInitialDirection);
     if (!mainRobot)
     {
+        dispose_pathfinder(mainPathfinder);
         dispose_arena(mainArena);
         free(maze);
         return NULL;
@@ -122,13 +136,26 @@ maze_t *create_maze(maze_settings_t settings)
     draw_robot(rParameters);
 
     maze->settings = settings;
+    maze->planTour = 1;
 
     return maze;
 }
 
+// A maze is solvable as long as the robot can get home, markers walled off from it are skipped by solve_maze.
+// Mazes from the spanning tree generators promise more, every free tile has to be reachable from every other one.
 int32_t validate_maze(maze_t *maze)
 {
-    return maze && validate_maze_settings(maze->settings) && validate_arena(maze->arena) && validate_robot(maze->robot) && are_all_spaces_connected(maze->arena);
+    if (!maze || !validate_maze_settings(maze->settings) || !validate_arena(maze->arena) || !validate_robot(maze->robot))
+    {
+        return 0;
+    }
+
+    if (maze->settings.connectedByConstruction)
+    {
+        return are_all_spaces_connected(maze->arena);
+    }
+
+    return pf_are_connected(maze->pathfinder, maze->settings.robotStartX, maze->settings.robotStartY, maze->settings.robotHomeX, maze->settings.robotHomeY);
 }
 
 void dispose_maze(maze_t *maze)
@@ -136,6 +163,7 @@ void dispose_maze(maze_t *maze)
     if (maze)
     {
         dispose_robot(maze->robot);
+        dispose_pathfinder(maze->pathfinder);
         dispose_arena(maze->arena);
         memset(maze, 0, sizeof(maze_t));
         free(maze);
@@ -152,11 +180,13 @@ int32_t modular_distance_diff(int32_t a, int32_t b, int32_t n)
     return distance;
 }
 
-void move_robot_in_directions(robot_t *robot, uint8_t *directions, int32_t size)
+// Returns the number of quarter turns it took
+uint32_t move_robot_in_directions(robot_t *robot, uint8_t *directions, int32_t size)
 {
+    uint32_t turns = 0;
     if (!robot || !directions || !size)
     {
-        return;
+        return turns;
     }
 
     for (int32_t i = 0; i < size; i++)
@@ -179,6 +209,7 @@ void move_robot_in_directions(robot_t *robot, uint8_t *directions, int32_t size)
             }
 
             directionDiff = modular_distance_diff(robot->direction, directions[i], 4);
+            turns++;
         }
 
         forward(robot);
@@ -190,109 +221,204 @@ void move_robot_in_directions(robot_t *robot, uint8_t *directions, int32_t size)
             pickUpMarker(robot);
         }
     }
+
+    return turns;
 }
 
-// Idea to use manhattan distance from https://www.geeksforgeeks.org/a-search-algorithm/
-uint32_t manhattan_distance(int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+// Moves the robot along the path and frees it, returns 0 if the path could not be turned into moves
+int32_t follow_path(maze_t *maze, node_t *path)
 {
-    return abs(x1 - x2) + abs(y1 - y2);
+    uint32_t size = 0;
+    uint8_t *directions = path_to_direction_list(path, &size);
+    free_path(path);
+    if (!directions || size == 0)
+    {
+        free(directions);
+        return 0;
+    }
+
+    maze->turnCount += move_robot_in_directions(maze->robot, directions, size);
+    maze->moveCount += size;
+    free(directions);
+    return 1;
 }
 
-uint32_t get_closest_marker_index(maze_t *maze)
+// Walks the robot to the goal starting with an already planned path, which is consumed. With the incremental planner
+// the robot checks the arena journal after every step and only replans once a tile changed between walkable and
+// blocked through maze_set_tile during the walk, the repair then only revisits the area around the change.
+int32_t walk_to(maze_t *maze, node_t *path, uint32_t goalX, uint32_t goalY)
 {
-    if (!validate_maze(maze))
+    if (maze->pathfinder->mode != PF_MODE_DSTAR_LITE)
     {
-        return -1;
+        return follow_path(maze, path);
     }
 
-    uint32_t index = -1;
-    uint32_t minDistance = INT_MAX;
-    for (uint32_t i = 0; i < maze->settings.markerCount; i++)
+    robot_t *robot = maze->robot;
+    while (path)
     {
-        if (get_tile(maze->arena, maze->settings.markersX[i], maze->settings.markersY[i]) != 0x02)
+        uint32_t size = 0;
+        uint8_t *directions = path_to_direction_list(path, &size);
+        free_path(path);
+        if (!directions || size == 0)
         {
-            continue;
+            free(directions);
+            return 0;
         }
 
-        uint32_t distance = manhattan_distance(maze->robot->x, maze->robot->y, maze->settings.markersX[i], maze->settings.markersY[i]);
-        if (distance < minDistance)
+        int32_t changed = 0;
+        for (uint32_t i = 0; i < size && !changed; i++)
         {
-            minDistance = distance;
-            index = i;
+            maze->turnCount += move_robot_in_directions(robot, directions + i, 1);
+            maze->moveCount++;
+            if (robot->x == goalX && robot->y == goalY)
+            {
+                free(directions);
+                return 1;
+            }
+
+            changed = pf_sync_changes(maze->pathfinder);
         }
+        free(directions);
+
+        path = changed ? pf_find_path(maze->pathfinder, robot->x, robot->y, robot->direction, goalX, goalY) : 0;
     }
 
-    return index;
+    return 0;
 }
 
-void solve_maze(maze_t *maze)
+// Plans the visiting order up front and walks it, markers picked up on the way are skipped
+void collect_markers_along_tour(maze_t *maze)
 {
-    if (!validate_maze(maze))
+    tour_t *tour = plan_marker_tour(maze->pathfinder, maze->robot->x, maze->robot->y, maze->robot->homeTileX, maze->robot->homeTileY, maze->settings.markerCount, maze->settings.markersX, maze->settings.markersY);
+    if (!tour)
     {
         return;
     }
 
-    while (maze->robot->markerCount < maze->settings.markerCount)
+    maze->plannedTourLength = tour->plannedLength;
+    maze->greedyTourLength = tour->greedyLength;
+
+    for (uint32_t i = 1; i + 1 < tour->pointCount; i++)
     {
-        uint32_t index = get_closest_marker_index(maze);
-        if (index < 0)
+        uint32_t markerX = tour->pointsX[tour->sequence[i]];
+        uint32_t markerY = tour->pointsY[tour->sequence[i]];
+        if (get_tile(maze->arena, markerX, markerY) != 0x02 || !pf_are_connected(maze->pathfinder, maze->robot->x, maze->robot->y, markerX, markerY))
         {
-            printf("No valid markers found.\n");
-            break;
+            continue;
         }
 
-        node_t *path = astar_search(maze->arena, maze->robot->x, maze->robot->y, maze->settings.markersX[index], maze->settings.markersY[index]);
+        node_t *path = pf_find_path(maze->pathfinder, maze->robot->x, maze->robot->y, maze->robot->direction, markerX, markerY);
         if (!path)
         {
-            printf("No path found to marker %d.\n", index);
+            if (maze->pathfinder->outOfMemory)
+            {
+                printf("Ran out of memory planning a path to marker at %u %u.\n", markerX, markerY);
+            }
+            else
+            {
+                printf("No path found to marker at %u %u.\n", markerX, markerY);
+            }
             break;
         }
 
-        uint32_t size = 0;
-        uint8_t *directions = path_to_direction_list(path, &size);
-        if (!directions || size == 0)
+        if (!walk_to(maze, path, markerX, markerY))
         {
-            printf("Invalid direction list for marker %d.\n", index);
-            free_path(path);
+            printf("Invalid direction list for marker at %u %u.\n", markerX, markerY);
             break;
         }
 
-        move_robot_in_directions(maze->robot, directions, size);
-
         pickUpMarker(maze->robot);
-
         update_robot();
+    }
 
-        free(directions);
-        free_path(path);
+    dispose_tour(tour);
+}
+
+// Markers of the maze that are still lying around and can be reached from where the robot stands
+uint32_t count_reachable_markers(maze_t *maze)
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < maze->settings.markerCount; i++)
+    {
+        uint32_t markerX = maze->settings.markersX[i];
+        uint32_t markerY = maze->settings.markersY[i];
+        count += get_tile(maze->arena, markerX, markerY) == 0x02 && pf_are_connected(maze->pathfinder, maze->robot->x, maze->robot->y, markerX, markerY);
     }
+    return count;
+}
 
-    node_t *path = astar_search(maze->arena, maze->robot->x, maze->robot->y, maze->robot->homeTileX, maze->robot->homeTileY);
-    if (path)
+void collect_nearest_markers(maze_t *maze)
+{
+    while (maze->robot->markerCount < maze->settings.markerCount && count_reachable_markers(maze))
     {
-        uint32_t size = 0;
-        uint8_t *directions = path_to_direction_list(path, &size);
-        if (directions && size > 0)
+        // one search picks the nearest marker by walking distance and finds the path to it
+        uint32_t markerX = 0, markerY = 0;
+        node_t *path = pf_nearest_marker_search(maze->pathfinder, maze->robot->x, maze->robot->y, &markerX, &markerY);
+        if (!path)
         {
-            move_robot_in_directions(maze->robot, directions, size);
-            free(directions);
+            printf("No reachable markers found.\n");
+            break;
         }
-        dropMarker(maze->robot);
-        free_path(path);
+
+        if (!walk_to(maze, path, markerX, markerY))
+        {
+            printf("Invalid direction list for marker at %u %u.\n", markerX, markerY);
+            break;
+        }
+
+        pickUpMarker(maze->robot);
+        update_robot();
     }
 }
 
-uint32_t generate_random_number(uint32_t min, uint32_t max)
+// Edits a tile, also while a solve is in progress, the pathfinder picks the change up from the arena journal
+void maze_set_tile(maze_t *maze, uint32_t x, uint32_t y, uint8_t type)
 {
-    return (rand() % (max - min + 1)) + min;
+    if (!maze)
+    {
+        return;
+    }
+
+    set_tile(maze->arena, x, y, type);
 }
 
-void set_settings_parameters(maze_settings_t *settings, uint32_t minWidth, uint32_t maxWidth, uint32_t minHeight, uint32_t maxHeight, uint32_t paddingSize, uint32_t backgroundColor0RGB, uint32_t pixelPerSide, double maxObstacleAreaPercentage, double maxMarkerAreaPercentage, uint32_t robotBorderColor0RGB, uint32_t robotFillColor0RGB)
+void solve_maze(maze_t *maze)
 {
-    srand((unsigned int)time(0));
+    if (!validate_maze(maze))
+    {
+        return;
+    }
+
+    uint32_t unreachable = maze->settings.markerCount - count_reachable_markers(maze);
+    if (unreachable)
+    {
+        printf("Skipping %u unreachable markers.\n", unreachable);
+    }
+
+    if (maze->planTour)
+    {
+        collect_markers_along_tour(maze);
+    }
+
+    // picks up whatever the tour could not, or everything when planning is disabled
+    collect_nearest_markers(maze);
 
-    uint32_t width = generate_random_number(minWidth, maxWidth);
-    uint32_t height = generate_random_number(minHeight, maxHeight);
+    node_t *path = pf_find_path(maze->pathfinder, maze->robot->x, maze->robot->y, maze->robot->direction, maze->robot->homeTileX, maze->robot->homeTileY);
+    if (path)
+    {
+        walk_to(maze, path, maze->robot->homeTileX, maze->robot->homeTileY);
+        dropMarker(maze->robot);
+    }
+    else if (maze->pathfinder->outOfMemory)
+    {
+        printf("Ran out of memory planning the path home.\n");
+    }
+}
+
+void set_settings_parameters(prng_t *prng, maze_settings_t *settings, uint32_t minWidth, uint32_t maxWidth, uint32_t minHeight, uint32_t maxHeight, uint32_t paddingSize, uint32_t backgroundColor0RGB, uint32_t pixelPerSide, double maxObstacleAreaPercentage, double maxMarkerAreaPercentage, uint32_t robotBorderColor0RGB, uint32_t robotFillColor0RGB)
+{
+    uint32_t width = prng_range(prng, minWidth, maxWidth);
+    uint32_t height = prng_range(prng, minHeight, maxHeight);
 
     width = width == 0 ? 1 : width;
     height = height == 0 ? 1 : height;
@@ -307,12 +433,12 @@ void set_settings_parameters(maze_settings_t *settings, uint32_t minWidth, uint3
 
     uint32_t maxObstacles = (width * height) * maxObstacleAreaPercentage;
 
-    uint32_t numObstacles = rand() % maxObstacles;
+    uint32_t numObstacles = prng_below(prng, maxObstacles);
     settings->obstacleCount = numObstacles;
 
     uint32_t maxMarkers = (width * height) * maxMarkerAreaPercentage;
 
-    uint32_t numMarkers = (maxMarkers > 0) ? (rand() % maxMarkers) : 0;
+    uint32_t numMarkers = prng_below(prng, maxMarkers);
     numMarkers = numMarkers == 0 ? 1 : numMarkers; // minimum 1 marker.
     settings->markerCount = numMarkers;
 
@@ -321,20 +447,12 @@ void set_settings_parameters(maze_settings_t *settings, uint32_t minWidth, uint3
     settings->nonExistentY = 0;
 }
 
-void set_random_robot(arena_t *arena, maze_settings_t *settings)
+// Home and start are two different empty tiles
+void set_random_robot(prng_t *prng, cell_pool_t *pool, maze_settings_t *settings)
 {
-    uint32_t homeX = rand() % arena->width;
-    uint32_t homeY = rand() % arena->height;
-    uint32_t startX = rand() % arena->width;
-    uint32_t startY = rand() % arena->height;
-
-    while ((get_tile(arena, homeX, homeY) != 0x00 || get_tile(arena, startX, startY) != 0x00) || (homeX == startX && homeY == startY))
-    {
-        homeX = rand() % arena->width;
-        homeY = rand() % arena->height;
-        startX = rand() % arena->width;
-        startY = rand() % arena->height;
-    }
+    uint32_t homeX = 0, homeY = 0, startX = 0, startY = 0;
+    cell_pool_take(pool, prng, &homeX, &homeY);
+    cell_pool_take(pool, prng, &startX, &startY);
 
     settings->robotHomeX = homeX;
     settings->robotHomeY = homeY;
@@ -342,195 +460,287 @@ void set_random_robot(arena_t *arena, maze_settings_t *settings)
     settings->robotStartY = startY;
 }
 
-void set_random_markers(arena_t *arena, maze_settings_t *settings)
+// The marker count is cut down when there are fewer empty tiles than markers
+void set_random_markers(prng_t *prng, arena_t *arena, cell_pool_t *pool, maze_settings_t *settings)
 {
     settings->markersX = malloc(settings->markerCount * sizeof(uint32_t));
     settings->markersY = malloc(settings->markerCount * sizeof(uint32_t));
-
-    for (uint32_t i = 0; i < settings->markerCount;)
+    if (!settings->markersX || !settings->markersY)
     {
-        uint32_t x = rand() % arena->width;
-        uint32_t y = rand() % arena->height;
+        settings->markerCount = 0;
+        return;
+    }
 
-        if (get_tile(arena, x, y) != 0x00)
-            continue;
+    for (uint32_t i = 0; i < settings->markerCount; i++)
+    {
+        uint32_t x = 0, y = 0;
+        if (!cell_pool_take(pool, prng, &x, &y))
+        {
+            settings->markerCount = i;
+            break;
+        }
 
         settings->markersX[i] = x;
         settings->markersY[i] = y;
         set_tile(arena, x, y, 0x02);
-
-        i++;
     }
 }
 
-void bfs(arena_t *arena, uint32_t *visited, uint32_t startX, uint32_t startY)
+// Every passable tile has to be reachable from every other one, checked with a bitset flood fill over the passability plane
+int32_t are_all_spaces_connected(arena_t *arena)
 {
-    if (arena == 0 || startX > arena->width - 1 || startY > arena->height - 1 || visited == 0)
+    if (!validate_arena(arena))
     {
-        return;
+        return 0;
     }
 
-    queue_t *queue = create_queue(arena->width * arena->height);
-
-    enqueue(queue, startX, startY);
-    visited[startX + startY * arena->width] = 1;
+    uint32_t startX = 0, startY = 0;
+    if (!find_passable(arena, &startX, &startY))
+    {
+        return 1;
+    }
 
-    while (!is_queue_empty(queue))
+    uint64_t *reached = malloc((size_t)arena->wordsPerRow * arena->height * sizeof(uint64_t));
+    if (!reached)
     {
-        queue_node_t node = dequeue(queue);
-        int x = node.x;
-        int y = node.y;
+        return 0;
+    }
 
-        int dX[] = {-1, 1, 0, 0}; // x directions
-        int dY[] = {0, 0, -1, 1}; // y directions
+    uint64_t reachedCount = flood_fill_passable(arena, startX, startY, reached);
+    free(reached);
+    return reachedCount == count_passable(arena);
+}
 
-        for (int i = 0; i < 4; i++)
-        {
-            int newX = x + dX[i];
-            int newY = y + dY[i];
+// Only places obstacles that keep every free tile reachable. Every candidate costs one connectivity test: a tile
+// that would disconnect the arena is deferred in the pool instead of being drawn again. Deferred tiles are only
+// tried again after new obstacles went in, which can turn a tile that walled off a dead end into one that no longer
+// does. When a whole pass places nothing the arena is full and the obstacle count is cut down to what was placed.
+void set_random_obstacles(prng_t *prng, arena_t *arena, cell_pool_t *pool, maze_settings_t *settings)
+{
+    settings->obstaclesX = malloc(settings->obstacleCount * sizeof(uint32_t));
+    settings->obstaclesY = malloc(settings->obstacleCount * sizeof(uint32_t));
+    connectivity_checker_t *checker = create_connectivity_checker(arena);
+    if (!settings->obstaclesX || !settings->obstaclesY || !checker)
+    {
+        settings->obstacleCount = 0;
+        dispose_connectivity_checker(checker);
+        return;
+    }
 
-            if (newX >= 0 && newX < arena->width && newY >= 0 && newY < arena->height &&
-                !visited[newX + newY * arena->width] && (get_tile(arena, newX, newY) == 0x02 || get_tile(arena, newX, newY) == 0x00))
+    uint32_t placed = 0;
+    uint32_t placedThisPass = 0;
+    while (placed < settings->obstacleCount)
+    {
+        uint32_t x = 0, y = 0;
+        if (!cell_pool_pick(pool, prng, &x, &y))
+        {
+            if (placedThisPass == 0 || cell_pool_recall(pool) == 0)
             {
-                visited[newX + newY * arena->width] = 1;
-                enqueue(queue, newX, newY);
+                break;
             }
+            placedThisPass = 0;
+            continue;
         }
+
+        if (would_disconnect(checker, x, y))
+        {
+            cell_pool_defer(pool, x, y);
+            continue;
+        }
+
+        settings->obstaclesX[placed] = x;
+        settings->obstaclesY[placed] = y;
+        set_tile(arena, x, y, 0x01);
+        cell_pool_remove(pool, x, y);
+        placed++;
+        placedThisPass++;
     }
 
-    dispose_queue(queue);
+    settings->obstacleCount = placed;
+    cell_pool_recall(pool);
+    dispose_connectivity_checker(checker);
 }
 
-int32_t are_all_spaces_connected(arena_t *arena)
+// Records every wall a generator left in the arena as an obstacle
+void set_generated_obstacles(arena_t *arena, maze_settings_t *settings)
 {
-    if (arena == 0)
+    settings->obstacleCount = 0;
+    for (uint32_t y = 0; y < arena->height; y++)
     {
-        return 0;
+        for (uint32_t x = 0; x < arena->width; x++)
+        {
+            settings->obstacleCount += get_tile(arena, x, y) == 0x01;
+        }
     }
 
-    uint32_t *visited = calloc(arena->width * arena->height, sizeof(uint32_t));
+    settings->obstaclesX = malloc(settings->obstacleCount * sizeof(uint32_t));
+    settings->obstaclesY = malloc(settings->obstacleCount * sizeof(uint32_t));
+    if (!settings->obstaclesX || !settings->obstaclesY)
+    {
+        settings->obstacleCount = 0;
+        return;
+    }
 
-    for (int x = 0; x < arena->width; x++)
+    uint32_t i = 0;
+    for (uint32_t y = 0; y < arena->height; y++)
     {
-        for (int y = 0; y < arena->height; y++)
+        for (uint32_t x = 0; x < arena->width; x++)
         {
-            if (get_tile(arena, x, y) == 0x02 || get_tile(arena, x, y) == 0x00)
+            if (get_tile(arena, x, y) == 0x01)
             {
-                bfs(arena, visited, x, y);
-                goto bfs_completed; // OMG A VALID GOTO STATEMENT
+                settings->obstaclesX[i] = x;
+                settings->obstaclesY[i] = y;
+                i++;
             }
         }
     }
+}
 
-bfs_completed:
+maze_workspace_t *create_maze_workspace(void)
+{
+    maze_workspace_t *workspace = malloc(sizeof(maze_workspace_t));
+    if (workspace)
+    {
+        memset(workspace, 0, sizeof(maze_workspace_t));
+    }
+    return workspace;
+}
 
-    for (int x = 0; x < arena->width; x++)
+void dispose_maze_workspace(maze_workspace_t *workspace)
+{
+    if (workspace)
     {
-        for (int y = 0; y < arena->height; y++)
-        {
-            if ((get_tile(arena, x, y) == 0x02 || get_tile(arena, x, y) == 0x00) && visited[x + y * arena->width] != 1)
-            {
-                free(visited);
-                return 0;
-            }
-        }
+        dispose_cell_pool(workspace->pool);
+        dispose_arena(workspace->arena);
+        free(workspace);
     }
+}
 
-    free(visited);
-    return 1;
+// Frees the coordinate lists of generated settings or settings read from a file
+void free_maze_settings(maze_settings_t *settings)
+{
+    free(settings->markersX);
+    free(settings->markersY);
+    free(settings->obstaclesX);
+    free(settings->obstaclesY);
+    free(settings->nonExistentX);
+    free(settings->nonExistentY);
+    settings->markersX = settings->markersY = 0;
+    settings->obstaclesX = settings->obstaclesY = 0;
+    settings->nonExistentX = settings->nonExistentY = 0;
+    settings->markerCount = settings->obstacleCount = settings->nonExistentCount = 0;
 }
 
-void set_random_obstacles(arena_t *arena, maze_settings_t *settings)
+// Generates a maze in the workspace's arena and pool, which are resized for it instead of allocated again.
+// Returns empty settings, which fail validation, when memory runs out or no draw is valid within the attempts.
+maze_settings_t generate_random_maze_in(maze_workspace_t *workspace, prng_t *prng, generator_type_t generator, uint32_t minWidth, uint32_t maxWidth, uint32_t minHeight, uint32_t maxHeight, uint32_t paddingSize, uint32_t backgroundColor0RGB, uint32_t pixelPerSide, double maxObstacleAreaPercentage, double maxMarkerAreaPercentage, uint32_t robotBorderColor0RGB, uint32_t robotFillColor0RGB)
 {
-    settings->obstaclesX = malloc(settings->obstacleCount * sizeof(uint32_t));
-    settings->obstaclesY = malloc(settings->obstacleCount * sizeof(uint32_t));
+    maze_settings_t settings;
+    memset(&settings, 0, sizeof(maze_settings_t));
 
-    uint32_t trialCount = 0;
-    for (uint32_t i = 0; i < settings->obstacleCount;)
+    if (!workspace || minWidth == 0 || maxWidth == 0 || minWidth > maxWidth || pixelPerSide == 0)
     {
-        uint32_t x = rand() % arena->width;
-        uint32_t y = rand() % arena->height;
+        return settings;
+    }
+
+    for (uint32_t attempt = 0; attempt < MAZE_GENERATION_ATTEMPTS; attempt++)
+    {
+        set_settings_parameters(prng, &settings, minWidth, maxWidth, minHeight, maxHeight, paddingSize, backgroundColor0RGB, pixelPerSide, maxObstacleAreaPercentage, maxMarkerAreaPercentage, robotBorderColor0RGB, robotFillColor0RGB);
 
-        if (get_tile(arena, x, y) != 0x00)
+        if (!reset_arena(workspace->arena, settings.width, settings.height))
         {
-            continue;
+            dispose_arena(workspace->arena);
+            workspace->arena = create_arena(settings.width, settings.height);
         }
 
-        settings->obstaclesX[i] = x;
-        settings->obstaclesY[i] = y;
-        set_tile(arena, x, y, 0x01);
-
-        if (are_all_spaces_connected(arena) == 0 && trialCount < 1000) // if this obstacle makes it so that we cannot reach a tile, regenerate it, try a 1000 times before giving up.
+        arena_t *arena = workspace->arena;
+        if (!arena)
         {
-            // revert the changes
-            settings->obstaclesX[i] = 0;
-            settings->obstaclesY[i] = 0;
-            set_tile(arena, x, y, 0x00);
-            trialCount++;
-            continue;
+            break;
         }
 
-        trialCount = 0;
-        i++;
-    }
-}
+        if (generator != GENERATOR_SCATTER)
+        {
+            // the walls are laid out before anything else is placed, the pool then only holds corridor tiles
+            settings.connectedByConstruction = generate_arena(arena, generator, prng);
+            set_generated_obstacles(arena, &settings);
+        }
 
-maze_settings_t generate_random_maze(uint32_t minWidth, uint32_t maxWidth, uint32_t minHeight, uint32_t maxHeight, uint32_t paddingSize, uint32_t backgroundColor0RGB, uint32_t pixelPerSide, double maxObstacleAreaPercentage, double maxMarkerAreaPercentage, uint32_t robotBorderColor0RGB, uint32_t robotFillColor0RGB)
-{
-    maze_settings_t settings;
-    memset(&settings, 0, sizeof(maze_settings_t));
+        if (!workspace->pool)
+        {
+            workspace->pool = create_cell_pool(arena);
+        }
+        else if (!refill_cell_pool(workspace->pool, arena))
+        {
+            break;
+        }
 
-    if (minWidth == 0 || maxWidth == 0 || minWidth > maxWidth || pixelPerSide == 0)
-    {
-        return settings;
-    }
+        cell_pool_t *pool = workspace->pool;
+        if (!pool)
+        {
+            break;
+        }
 
-    set_settings_parameters(&settings, minWidth, maxWidth, minHeight, maxHeight, paddingSize, backgroundColor0RGB, pixelPerSide, maxObstacleAreaPercentage, maxMarkerAreaPercentage, robotBorderColor0RGB, robotFillColor0RGB);
+        // the robot's tiles are taken out of the pool first so a crowded arena cannot leave it without room
+        set_random_robot(prng, pool, &settings);
+        set_random_markers(prng, arena, pool, &settings);
+        if (generator == GENERATOR_SCATTER)
+        {
+            set_random_obstacles(prng, arena, pool, &settings);
+        }
 
-    arena_t *arena = create_arena(settings.width, settings.height);
+        if (validate_maze_settings(settings))
+        {
+            return settings;
+        }
 
-    set_random_markers(arena, &settings);
-    set_random_obstacles(arena, &settings);
-    set_random_robot(arena, &settings);
+        // if settings are somehow invalid, regenerate with the next draws
+        free_maze_settings(&settings);
+    }
 
-    dispose_arena(arena);
+    free_maze_settings(&settings);
+    memset(&settings, 0, sizeof(maze_settings_t));
+    return settings;
+}
 
-    if (!validate_maze_settings(settings)) // if settings are somehow invalid, regenerate
-        return generate_random_maze(minWidth, maxWidth, minHeight, maxHeight, paddingSize, backgroundColor0RGB, pixelPerSide, maxObstacleAreaPercentage, maxMarkerAreaPercentage, robotBorderColor0RGB, robotFillColor0RGB);
+maze_settings_t generate_random_maze(prng_t *prng, generator_type_t generator, uint32_t minWidth, uint32_t maxWidth, uint32_t minHeight, uint32_t maxHeight, uint32_t paddingSize, uint32_t backgroundColor0RGB, uint32_t pixelPerSide, double maxObstacleAreaPercentage, double maxMarkerAreaPercentage, uint32_t robotBorderColor0RGB, uint32_t robotFillColor0RGB)
+{
+    maze_workspace_t *workspace = create_maze_workspace();
+    maze_settings_t settings = generate_random_maze_in(workspace, prng, generator, minWidth, maxWidth, minHeight, maxHeight, paddingSize, backgroundColor0RGB, pixelPerSide, maxObstacleAreaPercentage, maxMarkerAreaPercentage, robotBorderColor0RGB, robotFillColor0RGB);
+    dispose_maze_workspace(workspace);
     return settings;
 }
 
-// this can be copy pasted into a file and be run from a file if need be
-void print_maze_settings(const maze_settings_t *settings) // for debug purposes when generating random mazes
+// Writes settings in the file format read by -file
+int32_t write_maze_settings(FILE *file, const maze_settings_t *settings)
 {
-    printf("Maze Settings:\n");
-    printf("%u ", settings->width);
-    printf("%u ", settings->height);
-    printf("%u ", settings->paddingSize);
-    printf("0x%x ", settings->backgroundColor0RGB);
-    printf("%u\n", settings->pixelPerSide);
+    fprintf(file, "%u %u %u 0x%x %u\n", settings->width, settings->height, settings->paddingSize, settings->backgroundColor0RGB, settings->pixelPerSide);
 
-    printf("%u\n", settings->markerCount);
+    fprintf(file, "%u\n", settings->markerCount);
     for (uint32_t i = 0; i < settings->markerCount; ++i)
     {
-        printf("%u %u\n", settings->markersX[i], settings->markersY[i]);
+        fprintf(file, "%u %u\n", settings->markersX[i], settings->markersY[i]);
     }
 
-    printf("%u", settings->obstacleCount);
+    fprintf(file, "%u\n", settings->obstacleCount);
     for (uint32_t i = 0; i < settings->obstacleCount; ++i)
     {
-        printf("%u %u\n", settings->obstaclesX[i], settings->obstaclesY[i]);
+        fprintf(file, "%u %u\n", settings->obstaclesX[i], settings->obstaclesY[i]);
     }
 
-    printf("%u\n", settings->nonExistentCount);
+    fprintf(file, "%u\n", settings->nonExistentCount);
     for (uint32_t i = 0; i < settings->nonExistentCount; ++i)
     {
-        printf("%u %u\n", settings->nonExistentX[i], settings->nonExistentY[i]);
+        fprintf(file, "%u %u\n", settings->nonExistentX[i], settings->nonExistentY[i]);
     }
 
-    printf("%u %u ", settings->robotHomeX, settings->robotHomeY);
-    printf("%u %u ", settings->robotStartX, settings->robotStartY);
-    printf("%u ", settings->robotInitialDirection);
-    printf("%u ", settings->robotBorderColor0RGB);
-    printf("%u\n", settings->robotFillColor0RGB);
+    fprintf(file, "%u %u %u %u %u 0x%x 0x%x\n", settings->robotHomeX, settings->robotHomeY, settings->robotStartX, settings->robotStartY, settings->robotInitialDirection, settings->robotBorderColor0RGB, settings->robotFillColor0RGB);
+    return !ferror(file);
+}
+
+// this can be copy pasted into a file and be run from a file if need be
+void print_maze_settings(const maze_settings_t *settings) // for debug purposes when generating random mazes
+{
+    printf("Maze Settings:\n");
+    write_maze_settings(stdout, settings);
 }
\ No newline at end of file
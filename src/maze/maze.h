@@ -4,6 +4,13 @@
 #include "../arena/arena.h"
 #include "../robot/robot.h"
 #include "../drawing/drawing.h"
+#include "../pathfinder/pathfinder.h"
+#include "../prng/prng.h"
+#include "../generator/generator.h"
+#include "../cellpool/cellpool.h"
+#include <stdio.h>
+
+#define MAZE_GENERATION_ATTEMPTS 16
 
 typedef struct {
     uint32_t width;
@@ -31,23 +38,49 @@ typedef struct {
     uint32_t robotInitialDirection;
     uint32_t robotBorderColor0RGB;
     uint32_t robotFillColor0RGB;
+
+    arena_layout_t arenaLayout; // only picks how create_maze stores the arena, not part of the file format
+    int32_t connectedByConstruction; // set by the spanning tree generators, not part of the file format either
 } maze_settings_t;
 
 typedef struct {
     maze_settings_t settings;
     arena_t *arena;
     robot_t *robot;
+    pathfinder_t *pathfinder;
     arena_draw_parameters_t arenaParameters;
     robot_draw_parameters_t robotParameters;
+
+    // when set, solve_maze plans the marker visiting order before moving instead of always going to the nearest one
+    int32_t planTour;
+    uint32_t plannedTourLength;
+    uint32_t greedyTourLength;
+
+    // robot actions taken by solve_maze, every one of them is a redraw and a sleep
+    uint32_t moveCount;
+    uint32_t turnCount;
 } maze_t;
 
+// Arena and free tile pool kept from one generated maze to the next, so a thread generating many mazes reuses their
+// storage. A workspace must only be used by one thread at a time.
+typedef struct {
+    arena_t *arena;
+    cell_pool_t *pool;
+} maze_workspace_t;
+
 int32_t validate_maze_settings(maze_settings_t settings);
 maze_t *create_maze(maze_settings_t settings);
 int32_t validate_maze(maze_t *maze);
 void dispose_maze(maze_t *maze);
+void maze_set_tile(maze_t *maze, uint32_t x, uint32_t y, uint8_t type);
 void solve_maze(maze_t *maze);
 int32_t are_all_spaces_connected(arena_t *arena);
-maze_settings_t generate_random_maze(uint32_t minWidth, uint32_t maxWidth, uint32_t minHeight, uint32_t maxHeight, uint32_t paddingSize, uint32_t backgroundColor0RGB, uint32_t pixelPerSide, double maxObstacleAreaPercentage, double maxMarkerAreaPercentage, uint32_t robotBorderColor0RGB, uint32_t robotFillColor0RGB);
+maze_settings_t generate_random_maze(prng_t *prng, generator_type_t generator, uint32_t minWidth, uint32_t maxWidth, uint32_t minHeight, uint32_t maxHeight, uint32_t paddingSize, uint32_t backgroundColor0RGB, uint32_t pixelPerSide, double maxObstacleAreaPercentage, double maxMarkerAreaPercentage, uint32_t robotBorderColor0RGB, uint32_t robotFillColor0RGB);
+maze_workspace_t *create_maze_workspace(void);
+void dispose_maze_workspace(maze_workspace_t *workspace);
+maze_settings_t generate_random_maze_in(maze_workspace_t *workspace, prng_t *prng, generator_type_t generator, uint32_t minWidth, uint32_t maxWidth, uint32_t minHeight, uint32_t maxHeight, uint32_t paddingSize, uint32_t backgroundColor0RGB, uint32_t pixelPerSide, double maxObstacleAreaPercentage, double maxMarkerAreaPercentage, uint32_t robotBorderColor0RGB, uint32_t robotFillColor0RGB);
+void free_maze_settings(maze_settings_t *settings);
+int32_t write_maze_settings(FILE *file, const maze_settings_t *settings);
 void print_maze_settings(const maze_settings_t *settings);
 
 #endif
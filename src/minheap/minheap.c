@@ -143,3 +143,236 @@ void mh_decrease_key(min_heap_t *heap, uint32_t index, uint32_t new_f)
         i = mh_parent_index(i);
     }
 }
+
+// Index based variant used by the pathfinder workspace, entries are cell indices and the
+// position of every cell is written back into the caller owned slots array
+
+void swap_cells(index_min_heap_t *heap, uint32_t i, uint32_t j)
+{
+    uint32_t tempCell = heap->cells[i];
+    uint64_t tempKey = heap->keys[i];
+    heap->cells[i] = heap->cells[j];
+    heap->keys[i] = heap->keys[j];
+    heap->cells[j] = tempCell;
+    heap->keys[j] = tempKey;
+
+    heap->slots[heap->cells[i]] = i;
+    heap->slots[heap->cells[j]] = j;
+}
+
+index_min_heap_t *create_index_min_heap(uint32_t capacity, uint32_t *slots)
+{
+    if (!capacity || !slots)
+    {
+        return 0;
+    }
+
+    index_min_heap_t *heap = malloc(sizeof(index_min_heap_t));
+    if (!heap)
+    {
+        return 0;
+    }
+
+    heap->cells = malloc(capacity * sizeof(uint32_t));
+    heap->keys = malloc(capacity * sizeof(uint64_t));
+    if (!heap->cells || !heap->keys)
+    {
+        free(heap->cells);
+        free(heap->keys);
+        free(heap);
+        return 0;
+    }
+
+    heap->slots = slots;
+    heap->size = 0;
+    heap->capacity = capacity;
+
+    return heap;
+}
+
+void dispose_index_min_heap(index_min_heap_t *heap)
+{
+    if (heap)
+    {
+        free(heap->cells);
+        free(heap->keys);
+        free(heap);
+    }
+}
+
+void imh_clear(index_min_heap_t *heap)
+{
+    if (heap)
+    {
+        heap->size = 0;
+    }
+}
+
+void imh_sift_up(index_min_heap_t *heap, uint32_t i)
+{
+    while (i != 0 && heap->keys[mh_parent_index(i)] > heap->keys[i])
+    {
+        swap_cells(heap, i, mh_parent_index(i));
+        i = mh_parent_index(i);
+    }
+}
+
+void imh_sift_down(index_min_heap_t *heap, uint32_t i)
+{
+    while (1)
+    {
+        uint32_t smallest = i;
+        uint32_t l = mh_left_index(i);
+        uint32_t r = mh_right_index(i);
+
+        if (l < heap->size && heap->keys[l] < heap->keys[smallest])
+        {
+            smallest = l;
+        }
+
+        if (r < heap->size && heap->keys[r] < heap->keys[smallest])
+        {
+            smallest = r;
+        }
+
+        if (smallest == i)
+        {
+            return;
+        }
+
+        swap_cells(heap, i, smallest);
+        i = smallest;
+    }
+}
+
+void imh_insert(index_min_heap_t *heap, uint32_t cell, uint64_t key)
+{
+    if (!heap || heap->size == heap->capacity)
+    {
+        return;
+    }
+
+    uint32_t i = heap->size++;
+    heap->cells[i] = cell;
+    heap->keys[i] = key;
+    heap->slots[cell] = i;
+
+    imh_sift_up(heap, i);
+}
+
+uint32_t imh_extract_min(index_min_heap_t *heap)
+{
+    if (!heap || heap->size == 0)
+    {
+        return UINT32_MAX;
+    }
+
+    uint32_t root = heap->cells[0];
+    heap->size--;
+    if (heap->size > 0)
+    {
+        heap->cells[0] = heap->cells[heap->size];
+        heap->keys[0] = heap->keys[heap->size];
+        heap->slots[heap->cells[0]] = 0;
+        imh_sift_down(heap, 0);
+    }
+
+    return root;
+}
+
+void imh_decrease_key(index_min_heap_t *heap, uint32_t cell, uint64_t key)
+{
+    if (!heap)
+    {
+        return;
+    }
+
+    uint32_t i = heap->slots[cell];
+    if (i >= heap->size || heap->cells[i] != cell || key > heap->keys[i])
+    {
+        return;
+    }
+
+    heap->keys[i] = key;
+    imh_sift_up(heap, i);
+}
+
+int32_t imh_contains(index_min_heap_t *heap, uint32_t cell)
+{
+    if (!heap)
+    {
+        return 0;
+    }
+
+    uint32_t i = heap->slots[cell];
+    return i < heap->size && heap->cells[i] == cell;
+}
+
+// Smallest key without removing it, UINT64_MAX when the heap is empty
+uint64_t imh_min_key(index_min_heap_t *heap)
+{
+    return heap && heap->size ? heap->keys[0] : UINT64_MAX;
+}
+
+// Moves a cell already in the heap to a new key, up or down
+void imh_update_key(index_min_heap_t *heap, uint32_t cell, uint64_t key)
+{
+    if (!imh_contains(heap, cell))
+    {
+        return;
+    }
+
+    uint32_t i = heap->slots[cell];
+    uint64_t oldKey = heap->keys[i];
+    heap->keys[i] = key;
+    if (key < oldKey)
+    {
+        imh_sift_up(heap, i);
+    }
+    else
+    {
+        imh_sift_down(heap, i);
+    }
+}
+
+void imh_remove(index_min_heap_t *heap, uint32_t cell)
+{
+    if (!imh_contains(heap, cell))
+    {
+        return;
+    }
+
+    uint32_t i = heap->slots[cell];
+    heap->size--;
+    if (i == heap->size)
+    {
+        return;
+    }
+
+    uint64_t removedKey = heap->keys[i];
+    heap->cells[i] = heap->cells[heap->size];
+    heap->keys[i] = heap->keys[heap->size];
+    heap->slots[heap->cells[i]] = i;
+    if (heap->keys[i] < removedKey)
+    {
+        imh_sift_up(heap, i);
+    }
+    else
+    {
+        imh_sift_down(heap, i);
+    }
+}
+
+// Restores the heap order after keys were rewritten in place
+void imh_heapify(index_min_heap_t *heap)
+{
+    if (!heap)
+    {
+        return;
+    }
+
+    for (uint32_t i = heap->size / 2; i > 0; i--)
+    {
+        imh_sift_down(heap, i - 1);
+    }
+}
@@ -18,4 +18,24 @@ uint32_t mh_parent_index(uint32_t i);
 uint32_t mh_left_index(uint32_t i);
 uint32_t mh_right_index(uint32_t i);
 
+typedef struct {
+    uint32_t *cells;
+    uint64_t *keys;
+    uint32_t *slots;
+    uint32_t size;
+    uint32_t capacity;
+} index_min_heap_t;
+
+index_min_heap_t *create_index_min_heap(uint32_t capacity, uint32_t *slots);
+void dispose_index_min_heap(index_min_heap_t *heap);
+void imh_clear(index_min_heap_t *heap);
+void imh_insert(index_min_heap_t *heap, uint32_t cell, uint64_t key);
+uint32_t imh_extract_min(index_min_heap_t *heap);
+void imh_decrease_key(index_min_heap_t *heap, uint32_t cell, uint64_t key);
+int32_t imh_contains(index_min_heap_t *heap, uint32_t cell);
+uint64_t imh_min_key(index_min_heap_t *heap);
+void imh_update_key(index_min_heap_t *heap, uint32_t cell, uint64_t key);
+void imh_remove(index_min_heap_t *heap, uint32_t cell);
+void imh_heapify(index_min_heap_t *heap);
+
 #endif
@@ -0,0 +1,291 @@
+#include "./pathcache.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const int32_t headingX[4] = {0, 1, 0, -1};
+static const int32_t headingY[4] = {-1, 0, 1, 0};
+
+path_cache_t *create_path_cache(uint32_t entryCapacity, uint32_t byteBudget)
+{
+    if (!entryCapacity || !byteBudget)
+    {
+        return 0;
+    }
+
+    path_cache_t *cache = malloc(sizeof(path_cache_t));
+    if (!cache)
+    {
+        return 0;
+    }
+
+    memset(cache, 0, sizeof(path_cache_t));
+    cache->entryCapacity = entryCapacity;
+    cache->byteBudget = byteBudget;
+
+    // at least twice as many buckets as entries keeps the chains short
+    uint32_t bucketCount = 1;
+    while (bucketCount < entryCapacity * 2)
+    {
+        bucketCount *= 2;
+    }
+    cache->bucketMask = bucketCount - 1;
+
+    cache->entries = calloc(entryCapacity, sizeof(path_cache_entry_t));
+    cache->buckets = malloc(bucketCount * sizeof(uint32_t));
+    if (!cache->entries || !cache->buckets)
+    {
+        dispose_path_cache(cache);
+        return 0;
+    }
+
+    path_cache_clear(cache);
+    return cache;
+}
+
+void dispose_path_cache(path_cache_t *cache)
+{
+    if (cache)
+    {
+        path_cache_clear(cache);
+        free(cache->entries);
+        free(cache->buckets);
+        free(cache);
+    }
+}
+
+void path_cache_clear(path_cache_t *cache)
+{
+    if (!cache || !cache->entries || !cache->buckets)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < cache->entryCapacity; i++)
+    {
+        free(cache->entries[i].moves);
+        cache->entries[i].moves = 0;
+        cache->entries[i].hashNext = i + 1 < cache->entryCapacity ? i + 1 : PATH_CACHE_NONE;
+    }
+
+    for (uint32_t i = 0; i <= cache->bucketMask; i++)
+    {
+        cache->buckets[i] = PATH_CACHE_NONE;
+    }
+
+    cache->freeList = 0;
+    cache->entryCount = 0;
+    cache->newest = PATH_CACHE_NONE;
+    cache->oldest = PATH_CACHE_NONE;
+    cache->bytesUsed = 0;
+}
+
+uint32_t cache_bucket(path_cache_t *cache, uint32_t startCell, uint32_t goalCell, uint32_t mode)
+{
+    uint32_t hash = startCell * 0x9E3779B1u;
+    hash ^= goalCell + 0x7F4A7C15u + (hash << 6) + (hash >> 2);
+    hash ^= mode * 0x85EBCA6Bu;
+    return hash & cache->bucketMask;
+}
+
+uint32_t moves_bytes(uint32_t moveCount)
+{
+    return (moveCount + 3) / 4;
+}
+
+void lru_unlink(path_cache_t *cache, uint32_t index)
+{
+    path_cache_entry_t *entry = &cache->entries[index];
+    if (entry->newer != PATH_CACHE_NONE)
+    {
+        cache->entries[entry->newer].older = entry->older;
+    }
+    else
+    {
+        cache->newest = entry->older;
+    }
+
+    if (entry->older != PATH_CACHE_NONE)
+    {
+        cache->entries[entry->older].newer = entry->newer;
+    }
+    else
+    {
+        cache->oldest = entry->newer;
+    }
+}
+
+void lru_push_newest(path_cache_t *cache, uint32_t index)
+{
+    path_cache_entry_t *entry = &cache->entries[index];
+    entry->newer = PATH_CACHE_NONE;
+    entry->older = cache->newest;
+    if (cache->newest != PATH_CACHE_NONE)
+    {
+        cache->entries[cache->newest].newer = index;
+    }
+    cache->newest = index;
+    if (cache->oldest == PATH_CACHE_NONE)
+    {
+        cache->oldest = index;
+    }
+}
+
+void remove_entry(path_cache_t *cache, uint32_t index)
+{
+    path_cache_entry_t *entry = &cache->entries[index];
+    uint32_t *link = &cache->buckets[cache_bucket(cache, entry->startCell, entry->goalCell, entry->mode)];
+    while (*link != index)
+    {
+        link = &cache->entries[*link].hashNext;
+    }
+    *link = entry->hashNext;
+
+    lru_unlink(cache, index);
+    cache->bytesUsed -= moves_bytes(entry->moveCount);
+    cache->entryCount--;
+    free(entry->moves);
+    entry->moves = 0;
+    entry->hashNext = cache->freeList;
+    cache->freeList = index;
+}
+
+uint32_t find_entry(path_cache_t *cache, uint32_t startCell, uint32_t goalCell, uint32_t mode)
+{
+    uint32_t index = cache->buckets[cache_bucket(cache, startCell, goalCell, mode)];
+    while (index != PATH_CACHE_NONE)
+    {
+        path_cache_entry_t *entry = &cache->entries[index];
+        if (entry->startCell == startCell && entry->goalCell == goalCell && entry->mode == mode)
+        {
+            return index;
+        }
+        index = entry->hashNext;
+    }
+
+    return PATH_CACHE_NONE;
+}
+
+// Returns a fresh node chain for a cached path or 0 on a miss, entries from an older arena version are dropped
+node_t *path_cache_lookup(path_cache_t *cache, pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint32_t goalX, uint32_t goalY)
+{
+    if (!cache || !pathfinder)
+    {
+        return 0;
+    }
+
+    uint32_t startCell = arena_cell_index(pathfinder->arena, startX, startY);
+    uint32_t goalCell = arena_cell_index(pathfinder->arena, goalX, goalY);
+    uint32_t index = find_entry(cache, startCell, goalCell, pathfinder->mode);
+    if (index != PATH_CACHE_NONE && cache->entries[index].version != pathfinder->arena->version)
+    {
+        remove_entry(cache, index);
+        index = PATH_CACHE_NONE;
+    }
+
+    if (index == PATH_CACHE_NONE)
+    {
+        cache->misses++;
+        return 0;
+    }
+
+    path_cache_entry_t *entry = &cache->entries[index];
+    uint32_t *cells = malloc((entry->moveCount + 1) * sizeof(uint32_t));
+    if (!cells)
+    {
+        return 0;
+    }
+
+    int32_t x = startX;
+    int32_t y = startY;
+    cells[0] = startCell;
+    for (uint32_t i = 0; i < entry->moveCount; i++)
+    {
+        uint8_t heading = (entry->moves[i / 4] >> ((i % 4) * 2)) & 0x03;
+        x += headingX[heading];
+        y += headingY[heading];
+        cells[i + 1] = arena_cell_index(pathfinder->arena, x, y);
+    }
+
+    node_t *path = pf_build_path_from_cells(pathfinder, cells, entry->moveCount + 1, goalX, goalY);
+    free(cells);
+    if (path)
+    {
+        cache->hits++;
+        lru_unlink(cache, index);
+        lru_push_newest(cache, index);
+    }
+
+    return path;
+}
+
+// Remembers a path returned by a search for the current arena version, the path itself is not consumed
+void path_cache_store(path_cache_t *cache, pathfinder_t *pathfinder, node_t *path)
+{
+    if (!cache || !pathfinder || !path)
+    {
+        return;
+    }
+
+    uint32_t moveCount = 0;
+    node_t *start = path;
+    while (start->parent)
+    {
+        start = start->parent;
+        moveCount++;
+    }
+
+    uint32_t byteCount = moves_bytes(moveCount);
+    if (byteCount > cache->byteBudget)
+    {
+        return;
+    }
+
+    uint32_t startCell = arena_cell_index(pathfinder->arena, start->x, start->y);
+    uint32_t goalCell = arena_cell_index(pathfinder->arena, path->x, path->y);
+    uint32_t existing = find_entry(cache, startCell, goalCell, pathfinder->mode);
+    if (existing != PATH_CACHE_NONE)
+    {
+        remove_entry(cache, existing);
+    }
+
+    uint8_t *moves = calloc(byteCount ? byteCount : 1, sizeof(uint8_t));
+    if (!moves)
+    {
+        return;
+    }
+
+    // the chain runs from the goal back to the start, so moves are written from the last one
+    uint32_t i = moveCount;
+    for (node_t *node = path; node->parent; node = node->parent)
+    {
+        i--;
+        int32_t dx = (int32_t)node->x - (int32_t)node->parent->x;
+        int32_t dy = (int32_t)node->y - (int32_t)node->parent->y;
+        uint8_t heading = dy < 0 ? 0 : dx > 0 ? 1 : dy > 0 ? 2 : 3;
+        moves[i / 4] |= heading << ((i % 4) * 2);
+    }
+
+    while (cache->oldest != PATH_CACHE_NONE && (cache->entryCount == cache->entryCapacity || cache->bytesUsed + byteCount > cache->byteBudget))
+    {
+        remove_entry(cache, cache->oldest);
+        cache->evictions++;
+    }
+
+    uint32_t index = cache->freeList;
+    path_cache_entry_t *entry = &cache->entries[index];
+    cache->freeList = entry->hashNext;
+
+    entry->startCell = startCell;
+    entry->goalCell = goalCell;
+    entry->version = pathfinder->arena->version;
+    entry->mode = pathfinder->mode;
+    entry->moveCount = moveCount;
+    entry->moves = moves;
+
+    uint32_t bucket = cache_bucket(cache, startCell, goalCell, entry->mode);
+    entry->hashNext = cache->buckets[bucket];
+    cache->buckets[bucket] = index;
+    lru_push_newest(cache, index);
+    cache->entryCount++;
+    cache->bytesUsed += byteCount;
+}
@@ -0,0 +1,48 @@
+#ifndef __PATHCACHE_H__
+#define __PATHCACHE_H__
+
+#include "../pathfinder/pathfinder.h"
+
+#define PATH_CACHE_NONE UINT32_MAX
+#define PATH_CACHE_DEFAULT_ENTRIES 256
+#define PATH_CACHE_DEFAULT_BYTES (64 * 1024)
+
+// One cached path, moves are packed four to a byte using the robot's heading encoding
+typedef struct {
+    uint32_t startCell;
+    uint32_t goalCell;
+    uint32_t version;
+    uint32_t mode;
+    uint32_t moveCount;
+    uint8_t *moves;
+    uint32_t hashNext;
+    uint32_t newer;
+    uint32_t older;
+} path_cache_entry_t;
+
+// Paths keyed by (start, goal, search mode), an entry is only returned while the arena version it was
+// computed for is current. Memory is bounded by entryCapacity and byteBudget, the least recently used
+// entries are evicted first.
+typedef struct path_cache_t {
+    path_cache_entry_t *entries;
+    uint32_t entryCapacity;
+    uint32_t entryCount;
+    uint32_t *buckets;
+    uint32_t bucketMask;
+    uint32_t freeList;
+    uint32_t newest;
+    uint32_t oldest;
+    uint32_t byteBudget;
+    uint32_t bytesUsed;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+} path_cache_t;
+
+path_cache_t *create_path_cache(uint32_t entryCapacity, uint32_t byteBudget);
+void dispose_path_cache(path_cache_t *cache);
+void path_cache_clear(path_cache_t *cache);
+node_t *path_cache_lookup(path_cache_t *cache, pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint32_t goalX, uint32_t goalY);
+void path_cache_store(path_cache_t *cache, pathfinder_t *pathfinder, node_t *path);
+
+#endif
@@ -1,4 +1,11 @@
 #include "pathfinder.h"
+#include "../jps/jps.h"
+#include "../turnplanner/turnplanner.h"
+#include "../hpa/hpa.h"
+#include "../dstarlite/dstarlite.h"
+#include "../bidirectional/bidirectional.h"
+#include "../pathcache/pathcache.h"
+#include "../components/components.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -11,159 +18,596 @@ uint32_t heuristic(int32_t x1, int32_t y1, int32_t x2, int32_t y2)
     return abs(x1 - x2) + abs(y1 - y2);
 }
 
-// Refactored out from astar_search using ChatGPT-o1-preview, edited by me
-uint32_t allocate_nodes_and_closedList(uint32_t width, uint32_t height, node_t ****nodes, uint32_t ***closedList)
+// Cells are 32-bit here and UINT32_MAX is reserved for PF_NO_PARENT, larger arenas are refused
+pathfinder_t *create_pathfinder(arena_t *arena)
+{
+    if (!validate_arena(arena) || arena->cellCount >= PF_NO_PARENT)
+    {
+        return 0;
+    }
+
+    pathfinder_t *pathfinder = malloc(sizeof(pathfinder_t));
+    if (!pathfinder)
+    {
+        return 0;
+    }
+
+    memset(pathfinder, 0, sizeof(pathfinder_t));
+
+    pathfinder->arena = arena;
+    pathfinder->width = arena->width;
+    pathfinder->height = arena->height;
+    pathfinder->cellCount = arena->cellCount;
+    pathfinder->journalSequence = arena->journalEnd;
+
+    // stamps start zeroed and the generation starts at 1 so every cell begins untouched
+    pathfinder->generation = 1;
+    pathfinder->forwardCost = 1;
+    pathfinder->turnCost = 1;
+    pathfinder->g = malloc(pathfinder->cellCount * sizeof(uint32_t));
+    pathfinder->parent = malloc(pathfinder->cellCount * sizeof(uint32_t));
+    pathfinder->heapSlot = malloc(pathfinder->cellCount * sizeof(uint32_t));
+    pathfinder->stamp = calloc(pathfinder->cellCount, sizeof(uint32_t));
+    if (!pathfinder->g || !pathfinder->parent || !pathfinder->heapSlot || !pathfinder->stamp)
+    {
+        dispose_pathfinder(pathfinder);
+        return 0;
+    }
+
+    pathfinder->openList = create_priority_queue(PQ_BINARY_HEAP, pathfinder->cellCount, pathfinder->heapSlot);
+    pathfinder->frontier = create_queue(pathfinder->cellCount);
+    if (!pathfinder->openList || !pathfinder->frontier)
+    {
+        dispose_pathfinder(pathfinder);
+        return 0;
+    }
+
+    return pathfinder;
+}
+
+void dispose_pathfinder(pathfinder_t *pathfinder)
+{
+    if (pathfinder)
+    {
+        dispose_priority_queue(pathfinder->openList);
+        dispose_queue(pathfinder->frontier);
+        dispose_turn_planner(pathfinder->turnPlanner);
+        dispose_hpa(pathfinder->hpa);
+        dispose_dstar_lite(pathfinder->dstarLite);
+        dispose_pathfinder(pathfinder->reverse);
+        dispose_path_cache(pathfinder->cache);
+        dispose_component_labels(pathfinder->components);
+        free(pathfinder->g);
+        free(pathfinder->parent);
+        free(pathfinder->heapSlot);
+        free(pathfinder->stamp);
+        free(pathfinder);
+    }
+}
+
+// Invalidates every buffer of the previous query in O(1) by moving to a new generation
+void pf_begin_query(pathfinder_t *pathfinder)
+{
+    pathfinder->generation++;
+    if (pathfinder->generation == 0) // wrapped around, old stamps could collide with new generations
+    {
+        memset(pathfinder->stamp, 0, pathfinder->cellCount * sizeof(uint32_t));
+        pathfinder->generation = 1;
+    }
+
+    pq_clear(pathfinder->openList);
+    clear_queue(pathfinder->frontier);
+    pathfinder->outOfMemory = 0;
+}
+
+// Swaps the open list implementation, returns 0 and keeps the old one if the new one cannot be created
+int32_t pf_set_queue_type(pathfinder_t *pathfinder, priority_queue_type_t type)
 {
-    node_t ***localNodes = malloc(width * sizeof(node_t **));
-    uint32_t **localClosedList = malloc(width * sizeof(uint32_t *));
-    if (!localNodes || !localClosedList)
+    if (!pathfinder)
     {
         return 0;
     }
 
-    for (uint32_t i = 0; i < width; i++)
+    priority_queue_t *openList = create_priority_queue(type, pathfinder->cellCount, pathfinder->heapSlot);
+    if (!openList)
     {
-        localNodes[i] = calloc(height, sizeof(node_t *));
-        localClosedList[i] = calloc(height, sizeof(uint32_t));
-        if (!localNodes[i] || !localClosedList[i])
+        return 0;
+    }
+
+    dispose_priority_queue(pathfinder->openList);
+    pathfinder->openList = openList;
+
+    // the turn-aware and bidirectional workspaces are rebuilt with the new queue type on their next query
+    dispose_turn_planner(pathfinder->turnPlanner);
+    pathfinder->turnPlanner = 0;
+    dispose_pathfinder(pathfinder->reverse);
+    pathfinder->reverse = 0;
+    return 1;
+}
+
+// Repairs cached abstractions and searches after the passability of a tile changed
+void pf_notify_tile_changed(pathfinder_t *pathfinder, uint32_t x, uint32_t y)
+{
+    if (!pathfinder)
+    {
+        return;
+    }
+
+    hpa_notify_tile_changed(pathfinder->hpa, x, y);
+    dstar_lite_notify_tile_changed(pathfinder->dstarLite, x, y);
+}
+
+// Passes the arena changes made since the last call on to pf_notify_tile_changed, the hierarchical and incremental
+// searches call it first thing. When some changes already fell out of the journal the cluster graph and the
+// incremental planner are dropped and rebuilt on their next query. Returns 1 if a tile changed between walkable
+// and blocked, or if that is unknown because the journal no longer covers the changes.
+int32_t pf_sync_changes(pathfinder_t *pathfinder)
+{
+    arena_t *arena = pathfinder->arena;
+    if (!arena_journal_covers(arena, pathfinder->journalSequence))
+    {
+        dispose_hpa(pathfinder->hpa);
+        pathfinder->hpa = 0;
+        dispose_dstar_lite(pathfinder->dstarLite);
+        pathfinder->dstarLite = 0;
+        pathfinder->journalSequence = arena->journalEnd;
+        return 1;
+    }
+
+    int32_t changed = 0;
+    for (; pathfinder->journalSequence < arena->journalEnd; pathfinder->journalSequence++)
+    {
+        const arena_change_t *change = arena_change_at(arena, pathfinder->journalSequence);
+        if (is_walkable_tile(change->oldType) != is_walkable_tile(change->newType))
         {
-            return 0;
+            pf_notify_tile_changed(pathfinder, change->x, change->y);
+            changed = 1;
         }
     }
 
-    *nodes = localNodes;
-    *closedList = localClosedList;
-    return 1;
+    return changed;
 }
 
-// Refactored out from astar_search using ChatGPT-o1-preview, edited by me
-void free_nodes_and_closedList(uint32_t width, uint32_t height, node_t ***nodes, uint32_t **closedList, node_t *path)
+// Whether both tiles are walkable and reachable from each other. When the labels cannot be allocated the answer comes
+// from a search instead, which also answers 0 if it runs out of memory itself.
+int32_t pf_are_connected(pathfinder_t *pathfinder, uint32_t x1, uint32_t y1, uint32_t x2, uint32_t y2)
 {
-    for (uint32_t i = 0; i < width; i++)
+    if (!pathfinder)
     {
-        for (uint32_t j = 0; j < height; j++)
+        return 0;
+    }
+
+    if (!pathfinder->components)
+    {
+        pathfinder->components = create_component_labels(pathfinder->arena);
+        if (!pathfinder->components)
         {
-            int32_t isInPath = 0;
-            node_t *pathIterator = path;
-            while (pathIterator != 0)
+            if (!is_walkable_tile(get_tile(pathfinder->arena, x1, y1)) || !is_walkable_tile(get_tile(pathfinder->arena, x2, y2)))
             {
-                if (nodes[i][j] && nodes[i][j] == pathIterator)
-                {
-                    isInPath = 1;
-                    break;
-                }
-                pathIterator = pathIterator->parent;
+                return 0;
             }
 
-            if (isInPath == 0)
-            {
-                free(nodes[i][j]);
-            }
+            node_t *path = pf_astar_search(pathfinder, x1, y1, x2, y2);
+            int32_t connected = path != 0;
+            free_path(path);
+            return connected;
         }
-        free(nodes[i]);
-        free(closedList[i]);
     }
 
-    free(nodes);
-    free(closedList);
+    return components_connected(pathfinder->components, x1, y1, x2, y2);
 }
 
-// Refactored out from astar_search using ChatGPT-o1-preview, edited by me
-void process_neighbor(node_t *current, int32_t nx, int32_t ny, node_t ***nodes, uint32_t **closedList, min_heap_t *openList, arena_t *arena, uint32_t goalX, uint32_t goalY, uint32_t width, uint32_t height)
+// Replaces the path cache used by pf_find_path, a zero capacity turns caching off
+int32_t pf_set_cache(pathfinder_t *pathfinder, uint32_t entryCapacity, uint32_t byteBudget)
 {
-    if (nx < 0 || ny < 0 || nx >= width || ny >= height)
+    if (!pathfinder)
     {
-        return;
+        return 0;
     }
 
-    if (closedList[nx][ny] || get_tile(arena, nx, ny) == 0x01 || get_tile(arena, nx, ny) == 0xFF)
+    dispose_path_cache(pathfinder->cache);
+    pathfinder->cache = 0;
+    if (!entryCapacity || !byteBudget)
     {
-        return;
+        return 1;
     }
 
-    uint32_t g = current->g + 1;
-    uint32_t h = heuristic(nx, ny, goalX, goalY);
-    uint32_t f = g + h;
+    pathfinder->cache = create_path_cache(entryCapacity, byteBudget);
+    return pathfinder->cache != 0;
+}
+
+int32_t pf_is_visited(pathfinder_t *pathfinder, uint32_t cell)
+{
+    return pathfinder->stamp[cell] == pathfinder->generation;
+}
 
-    node_t *neighbor = nodes[nx][ny];
-    if (neighbor == 0)
+// Copies the parent indices from goalCell back to the start into one compact node_t block.
+// block[0] is the start node, so the path owns exactly one allocation and outlives the search state.
+// Consecutive parents may be a straight line apart (jump point search), the cells in between are filled in.
+node_t *pf_build_path(pathfinder_t *pathfinder, uint32_t goalCell, uint32_t goalX, uint32_t goalY)
+{
+    uint32_t length = 1;
+    for (uint32_t cell = goalCell; pathfinder->parent[cell] != PF_NO_PARENT; cell = pathfinder->parent[cell])
     {
-        neighbor = create_node(nx, ny, g, h, current);
-        nodes[nx][ny] = neighbor;
-        mh_insert(openList, neighbor);
+        uint32_t parent = pathfinder->parent[cell];
+        length += heuristic(arena_cell_x(pathfinder->arena, cell), arena_cell_y(pathfinder->arena, cell), arena_cell_x(pathfinder->arena, parent), arena_cell_y(pathfinder->arena, parent));
     }
-    else
+
+    node_t *block = malloc(length * sizeof(node_t));
+    if (!block)
     {
-        if (g < neighbor->g)
+        return 0;
+    }
+
+    uint32_t cell = goalCell;
+    int32_t x = goalX;
+    int32_t y = goalY;
+    uint32_t g = pathfinder->g[goalCell];
+    for (int32_t i = length - 1; i >= 0; i--)
+    {
+        node_t *node = &block[i];
+        node->x = x;
+        node->y = y;
+        node->g = g;
+        node->h = heuristic(x, y, goalX, goalY);
+        node->f = node->g + node->h;
+        node->heapIndex = -1;
+        node->parent = i > 0 ? &block[i - 1] : 0;
+
+        if (i == 0)
+        {
+            break;
+        }
+
+        uint32_t parent = pathfinder->parent[cell];
+        int32_t parentX = arena_cell_x(pathfinder->arena, parent);
+        int32_t parentY = arena_cell_y(pathfinder->arena, parent);
+        x += (parentX > x) - (parentX < x);
+        y += (parentY > y) - (parentY < y);
+        g--;
+        if (x == parentX && y == parentY)
         {
-            neighbor->g = g;
-            neighbor->h = h;
-            neighbor->f = f;
-            neighbor->parent = current;
-            mh_decrease_key(openList, neighbor->heapIndex, neighbor->f);
+            cell = parent;
         }
     }
+
+    return &block[length - 1];
 }
 
-node_t *astar_search(arena_t *arena, uint32_t startX, uint32_t startY, uint32_t goalX, uint32_t goalY)
+// Same compact block as pf_build_path for searches that produce the route as a list of adjacent cells
+node_t *pf_build_path_from_cells(pathfinder_t *pathfinder, uint32_t *cells, uint32_t count, uint32_t goalX, uint32_t goalY)
 {
-    uint32_t width = arena->width;
-    uint32_t height = arena->height;
+    if (!count)
+    {
+        return 0;
+    }
 
-    node_t ***nodes = 0;
-    uint32_t **closedList = 0;
-    if (!allocate_nodes_and_closedList(width, height, &nodes, &closedList))
+    node_t *block = malloc(count * sizeof(node_t));
+    if (!block)
     {
         return 0;
     }
 
-    min_heap_t *openList = create_min_heap(64);
-    if (!openList)
+    for (uint32_t i = 0; i < count; i++)
+    {
+        node_t *node = &block[i];
+        node->x = arena_cell_x(pathfinder->arena, cells[i]);
+        node->y = arena_cell_y(pathfinder->arena, cells[i]);
+        node->g = i;
+        node->h = heuristic(node->x, node->y, goalX, goalY);
+        node->f = node->g + node->h;
+        node->heapIndex = -1;
+        node->parent = i > 0 ? &block[i - 1] : 0;
+    }
+
+    return &block[count - 1];
+}
+
+int32_t pf_is_walkable(pathfinder_t *pathfinder, int32_t x, int32_t y)
+{
+    if (x < 0 || y < 0 || x >= pathfinder->width || y >= pathfinder->height)
     {
-        free_nodes_and_closedList(width, height, nodes, closedList, 0);
         return 0;
     }
 
-    node_t *startNode = create_node(startX, startY, 0, heuristic(startX, startY, goalX, goalY), 0);
-    mh_insert(openList, startNode);
-    nodes[startX][startY] = startNode;
+    // straight from the passability plane, bounds are already checked and the arena is validated at creation
+    arena_t *arena = pathfinder->arena;
+    if (arena->layout == ARENA_LAYOUT_SPARSE)
+    {
+        return arena_is_passable(arena, x, y);
+    }
+    return (arena->passable[(uint64_t)y * arena->wordsPerRow + x / ARENA_WORD_BITS] >> (x % ARENA_WORD_BITS)) & 1;
+}
 
-    node_t *current = 0;
-    while (openList->data->size > 0)
+// Refactored out from astar_search using ChatGPT-o1-preview, edited by me
+// Returns 0 when the open list ran out of memory and the search has to stop
+int32_t process_neighbor(pathfinder_t *pathfinder, uint32_t current, int32_t nx, int32_t ny, uint32_t goalX, uint32_t goalY)
+{
+    arena_t *arena = pathfinder->arena;
+    uint32_t cell;
+    if (arena->layout == ARENA_LAYOUT_BORDERED)
     {
-        current = mh_extract_min(openList);
-        if (!current)
+        // neighbours off the arena land on the sentinel border, which is never walkable
+        cell = arena_bordered_index(arena, nx, ny);
+        if (!arena_walkable_at(arena, cell))
         {
-            break;
+            return 1;
+        }
+    }
+    else
+    {
+        if (nx < 0 || ny < 0 || nx >= pathfinder->width || ny >= pathfinder->height || !pf_is_walkable(pathfinder, nx, ny))
+        {
+            return 1;
         }
-        closedList[current->x][current->y] = 1;
+        cell = arena_cell_index(arena, nx, ny);
+    }
+
+    int32_t visited = pf_is_visited(pathfinder, cell);
+    if (visited && pathfinder->heapSlot[cell] == PF_CLOSED)
+    {
+        return 1;
+    }
+
+    uint32_t g = pathfinder->g[current] + 1;
+    uint32_t f = g + heuristic(nx, ny, goalX, goalY);
 
-        if (current->x == goalX && current->y == goalY)
+    if (!visited)
+    {
+        pathfinder->stamp[cell] = pathfinder->generation;
+        pathfinder->g[cell] = g;
+        pathfinder->parent[cell] = current;
+        pathfinder->stats.heapOperations++;
+        if (!pq_push(pathfinder->openList, cell, f, g))
         {
-            break;
+            pathfinder->outOfMemory = 1;
+            return 0;
         }
+    }
+    else if (g < pathfinder->g[cell])
+    {
+        pathfinder->g[cell] = g;
+        pathfinder->parent[cell] = current;
+        pathfinder->stats.heapOperations++;
+        if (!pq_decrease_key(pathfinder->openList, cell, f, g))
+        {
+            pathfinder->outOfMemory = 1;
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+node_t *pf_astar_search(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint32_t goalX, uint32_t goalY)
+{
+    if (!pathfinder || startX >= pathfinder->width || startY >= pathfinder->height || goalX >= pathfinder->width || goalY >= pathfinder->height)
+    {
+        return 0;
+    }
+
+    pf_begin_query(pathfinder);
+
+    uint32_t startCell = arena_cell_index(pathfinder->arena, startX, startY);
+    uint32_t goalCell = arena_cell_index(pathfinder->arena, goalX, goalY);
+
+    pathfinder->stamp[startCell] = pathfinder->generation;
+    pathfinder->g[startCell] = 0;
+    pathfinder->parent[startCell] = PF_NO_PARENT;
+    pathfinder->stats.heapOperations++;
+    if (!pq_push(pathfinder->openList, startCell, heuristic(startX, startY, goalX, goalY), 0))
+    {
+        pathfinder->outOfMemory = 1;
+        return 0;
+    }
+
+    while (!pq_is_empty(pathfinder->openList))
+    {
+        uint32_t current = pq_pop(pathfinder->openList);
+        pathfinder->heapSlot[current] = PF_CLOSED;
+        pathfinder->stats.heapOperations++;
+        pathfinder->stats.expandedNodes++;
+
+        if (current == goalCell)
+        {
+            return pf_build_path(pathfinder, goalCell, goalX, goalY);
+        }
+
+        int32_t x = arena_cell_x(pathfinder->arena, current);
+        int32_t y = arena_cell_y(pathfinder->arena, current);
 
         int32_t neighbors[4][2] = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}};
         for (int32_t i = 0; i < 4; i++)
         {
-            int32_t nx = current->x + neighbors[i][0];
-            int32_t ny = current->y + neighbors[i][1];
-            process_neighbor(current, nx, ny, nodes, closedList, openList, arena, goalX, goalY, width, height);
+            if (!process_neighbor(pathfinder, current, x + neighbors[i][0], y + neighbors[i][1], goalX, goalY))
+            {
+                return 0;
+            }
         }
     }
 
-    node_t *path = 0;
-    if (current && current->x == goalX && current->y == goalY)
+    return 0;
+}
+
+// Breadth-first search from the start over the workspace that never leaves the inclusive rectangle
+// (minX, minY)-(maxX, maxY), returns the first marker cell it reaches when stopAtMarker is set,
+// otherwise runs until every reachable cell has its distance in g
+uint32_t pf_breadth_first_search(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, int32_t stopAtMarker)
+{
+    pf_begin_query(pathfinder);
+
+    arena_t *arena = pathfinder->arena;
+    int32_t bordered = arena->layout == ARENA_LAYOUT_BORDERED;
+    uint32_t startCell = arena_cell_index(arena, startX, startY);
+    pathfinder->stamp[startCell] = pathfinder->generation;
+    pathfinder->g[startCell] = 0;
+    pathfinder->parent[startCell] = PF_NO_PARENT;
+    enqueue(pathfinder->frontier, startX, startY);
+
+    while (!is_queue_empty(pathfinder->frontier))
+    {
+        queue_node_t node = dequeue(pathfinder->frontier);
+        uint32_t current = bordered ? arena_bordered_index(arena, node.x, node.y) : arena_cell_index(arena, node.x, node.y);
+        pathfinder->stats.expandedNodes++;
+
+        if (stopAtMarker && arena_is_marker(pathfinder->arena, node.x, node.y))
+        {
+            return current;
+        }
+
+        int32_t neighbors[4][2] = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+        for (int32_t i = 0; i < 4; i++)
+        {
+            int32_t nx = node.x + neighbors[i][0];
+            int32_t ny = node.y + neighbors[i][1];
+            if (nx < minX || ny < minY || nx > maxX || ny > maxY)
+            {
+                continue;
+            }
+
+            // the rectangle lies inside the arena, a bordered one can read the tile byte without further checks
+            uint32_t cell = bordered ? arena_bordered_index(arena, nx, ny) : arena_cell_index(arena, nx, ny);
+            if (!(bordered ? arena_walkable_at(arena, cell) : pf_is_walkable(pathfinder, nx, ny)) || pf_is_visited(pathfinder, cell))
+            {
+                continue;
+            }
+
+            pathfinder->stamp[cell] = pathfinder->generation;
+            pathfinder->g[cell] = pathfinder->g[current] + 1;
+            pathfinder->parent[cell] = current;
+            enqueue(pathfinder->frontier, nx, ny);
+        }
+    }
+
+    return PF_NO_PARENT;
+}
+
+// Since every step costs 1 the first marker reached is the truly nearest one and the path to it comes from the same pass
+node_t *pf_nearest_marker_search(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint32_t *markerX, uint32_t *markerY)
+{
+    if (!pathfinder || !markerX || !markerY || startX >= pathfinder->width || startY >= pathfinder->height)
+    {
+        return 0;
+    }
+
+    uint32_t markerCell = pf_breadth_first_search(pathfinder, startX, startY, 0, 0, pathfinder->width - 1, pathfinder->height - 1, 1);
+    if (markerCell == PF_NO_PARENT)
+    {
+        return 0;
+    }
+
+    *markerX = arena_cell_x(pathfinder->arena, markerCell);
+    *markerY = arena_cell_y(pathfinder->arena, markerCell);
+    return pf_build_path(pathfinder, markerCell, *markerX, *markerY);
+}
+
+// Fills the workspace with walking distances from the start, read them back with pf_get_distance
+int32_t pf_compute_distance_field(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY)
+{
+    if (!pathfinder || startX >= pathfinder->width || startY >= pathfinder->height)
     {
-        path = current;
+        return 0;
     }
 
-    free_nodes_and_closedList(width, height, nodes, closedList, path);
-    dispose_min_heap(openList);
+    pf_breadth_first_search(pathfinder, startX, startY, 0, 0, pathfinder->width - 1, pathfinder->height - 1, 0);
+    return 1;
+}
+
+// Same as pf_compute_distance_field but the search stays inside the inclusive rectangle
+int32_t pf_compute_bounded_distance_field(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint32_t minX, uint32_t minY, uint32_t maxX, uint32_t maxY)
+{
+    if (!pathfinder || startX < minX || startY < minY || startX > maxX || startY > maxY || maxX >= pathfinder->width || maxY >= pathfinder->height)
+    {
+        return 0;
+    }
+
+    pf_breadth_first_search(pathfinder, startX, startY, minX, minY, maxX, maxY, 0);
+    return 1;
+}
+
+uint32_t pf_get_distance(pathfinder_t *pathfinder, uint32_t x, uint32_t y)
+{
+    if (!pathfinder || x >= pathfinder->width || y >= pathfinder->height)
+    {
+        return PF_UNREACHABLE;
+    }
+
+    uint32_t cell = arena_cell_index(pathfinder->arena, x, y);
+    return pf_is_visited(pathfinder, cell) ? pathfinder->g[cell] : PF_UNREACHABLE;
+}
+
+node_t *pf_search(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint8_t startHeading, uint32_t goalX, uint32_t goalY)
+{
+    switch (pathfinder->mode)
+    {
+        case PF_MODE_JPS:
+            return jps_search(pathfinder, startX, startY, goalX, goalY);
+        case PF_MODE_TURN_AWARE:
+            return turn_aware_search(pathfinder, startX, startY, startHeading, goalX, goalY);
+        case PF_MODE_HPA:
+            return hpa_search(pathfinder, startX, startY, goalX, goalY);
+        case PF_MODE_DSTAR_LITE:
+            return dstar_lite_search(pathfinder, startX, startY, goalX, goalY);
+        case PF_MODE_BIDIRECTIONAL:
+            return bidirectional_search(pathfinder, startX, startY, goalX, goalY);
+        case PF_MODE_ASTAR:
+        default:
+            return pf_astar_search(pathfinder, startX, startY, goalX, goalY);
+    }
+}
+
+// Only searches whose result depends on nothing but the endpoints and the arena layout go through the cache,
+// the turn-aware one also depends on the heading and the incremental one is already cheap to repeat
+int32_t pf_is_cacheable_mode(pathfinder_mode_t mode)
+{
+    return mode != PF_MODE_TURN_AWARE && mode != PF_MODE_DSTAR_LITE;
+}
+
+// startHeading is only used by the turn-aware mode
+node_t *pf_find_path(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint8_t startHeading, uint32_t goalX, uint32_t goalY)
+{
+    if (!pathfinder || startX >= pathfinder->width || startY >= pathfinder->height || goalX >= pathfinder->width || goalY >= pathfinder->height)
+    {
+        return 0;
+    }
+
+    // once the labels exist a goal in another component is turned down without exploring the start's component
+    if (pathfinder->components && !components_connected(pathfinder->components, startX, startY, goalX, goalY))
+    {
+        return 0;
+    }
+
+    if (!pathfinder->cache || !pf_is_cacheable_mode(pathfinder->mode))
+    {
+        return pf_search(pathfinder, startX, startY, startHeading, goalX, goalY);
+    }
+
+    node_t *path = path_cache_lookup(pathfinder->cache, pathfinder, startX, startY, goalX, goalY);
+    if (!path)
+    {
+        path = pf_search(pathfinder, startX, startY, startHeading, goalX, goalY);
+        path_cache_store(pathfinder->cache, pathfinder, path);
+    }
+
+    return path;
+}
+
+// Convenience wrapper for one-off queries, repeated queries should keep a pathfinder_t around
+node_t *astar_search(arena_t *arena, uint32_t startX, uint32_t startY, uint32_t goalX, uint32_t goalY)
+{
+    pathfinder_t *pathfinder = create_pathfinder(arena);
+    if (!pathfinder)
+    {
+        return 0;
+    }
+
+    node_t *path = pf_astar_search(pathfinder, startX, startY, goalX, goalY);
+    dispose_pathfinder(pathfinder);
 
     return path;
 }
 
+// Paths are single blocks whose first element is the start node, so freeing the root frees all of it
 void free_path(node_t *goal)
 {
     if (!goal)
@@ -171,13 +615,13 @@ void free_path(node_t *goal)
         return;
     }
 
-    node_t *pathIterator = goal;
-    while (pathIterator != 0)
+    node_t *root = goal;
+    while (root->parent != 0)
     {
-        node_t *next = pathIterator->parent;
-        free(pathIterator);
-        pathIterator = next;
+        root = root->parent;
     }
+
+    free(root);
 }
 
 uint32_t get_direction(int32_t x_shift, int32_t y_shift)
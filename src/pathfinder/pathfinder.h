@@ -2,7 +2,80 @@
 #define __PATHFINDER_H__
 
 #include "../arena/arena.h"
-#include "../minheap/minheap.h"
+#include "../priorityqueue/priorityqueue.h"
+#include "../queue/queue.h"
+
+#define PF_NO_PARENT UINT32_MAX
+#define PF_CLOSED UINT32_MAX
+#define PF_UNREACHABLE UINT32_MAX
+
+typedef enum {
+    PF_MODE_ASTAR,
+    PF_MODE_JPS,
+    PF_MODE_TURN_AWARE,
+    PF_MODE_HPA,
+    PF_MODE_DSTAR_LITE,
+    PF_MODE_BIDIRECTIONAL
+} pathfinder_mode_t;
+
+typedef struct {
+    uint64_t expandedNodes;
+    uint64_t heapOperations;
+} pathfinder_stats_t;
+
+struct turn_planner_t;
+struct hpa_t;
+struct dstar_lite_t;
+struct path_cache_t;
+struct component_labels_t;
+
+// Reusable search workspace bound to one arena, all buffers are flat and indexed by arena_cell_index.
+// Entries are only meaningful when stamp[cell] == generation, so a new query invalidates them in O(1).
+typedef struct pathfinder_t {
+    arena_t *arena;
+    uint32_t width;
+    uint32_t height;
+    uint32_t cellCount;
+    uint32_t generation;
+    uint32_t *g;
+    uint32_t *parent;
+    uint32_t *heapSlot;
+    uint32_t *stamp;
+    priority_queue_t *openList;
+    queue_t *frontier;
+    struct turn_planner_t *turnPlanner; // created on the first turn-aware query
+    struct hpa_t *hpa; // cluster abstraction, created on the first hierarchical query
+    struct dstar_lite_t *dstarLite; // incremental planner, kept between queries towards the same goal
+    struct pathfinder_t *reverse; // goal side workspace of the bidirectional search, created on its first query
+    struct path_cache_t *cache; // results of pf_find_path, off unless set with pf_set_cache
+    struct component_labels_t *components; // reachability index, created by the first pf_are_connected
+    uint64_t journalSequence; // arena changes before this one were passed to pf_notify_tile_changed
+    uint32_t forwardCost;
+    uint32_t turnCost;
+    pathfinder_mode_t mode;
+    pathfinder_stats_t stats;
+    int32_t outOfMemory; // the last search stopped because its open list could not grow, so a missing path proves nothing
+} pathfinder_t;
+
+pathfinder_t *create_pathfinder(arena_t *arena);
+void dispose_pathfinder(pathfinder_t *pathfinder);
+void pf_begin_query(pathfinder_t *pathfinder);
+int32_t pf_set_queue_type(pathfinder_t *pathfinder, priority_queue_type_t type);
+int32_t pf_set_cache(pathfinder_t *pathfinder, uint32_t entryCapacity, uint32_t byteBudget);
+int32_t pf_is_visited(pathfinder_t *pathfinder, uint32_t cell);
+void pf_notify_tile_changed(pathfinder_t *pathfinder, uint32_t x, uint32_t y);
+int32_t pf_sync_changes(pathfinder_t *pathfinder);
+int32_t pf_are_connected(pathfinder_t *pathfinder, uint32_t x1, uint32_t y1, uint32_t x2, uint32_t y2);
+node_t *pf_build_path(pathfinder_t *pathfinder, uint32_t goalCell, uint32_t goalX, uint32_t goalY);
+node_t *pf_build_path_from_cells(pathfinder_t *pathfinder, uint32_t *cells, uint32_t count, uint32_t goalX, uint32_t goalY);
+int32_t pf_is_walkable(pathfinder_t *pathfinder, int32_t x, int32_t y);
+int32_t process_neighbor(pathfinder_t *pathfinder, uint32_t current, int32_t nx, int32_t ny, uint32_t goalX, uint32_t goalY);
+node_t *pf_astar_search(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint32_t goalX, uint32_t goalY);
+node_t *pf_nearest_marker_search(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint32_t *markerX, uint32_t *markerY);
+int32_t pf_compute_distance_field(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY);
+int32_t pf_compute_bounded_distance_field(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint32_t minX, uint32_t minY, uint32_t maxX, uint32_t maxY);
+uint32_t pf_get_distance(pathfinder_t *pathfinder, uint32_t x, uint32_t y);
+node_t *pf_find_path(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint8_t startHeading, uint32_t goalX, uint32_t goalY);
 
 uint32_t heuristic(int32_t x1, int32_t y1, int32_t x2, int32_t y2);
 node_t *astar_search(arena_t *arena, uint32_t startX, uint32_t startY, uint32_t goalX, uint32_t goalY);
@@ -0,0 +1,514 @@
+#include "./priorityqueue.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Bucket queue idea from Dial's algorithm, radix heap from https://en.wikipedia.org/wiki/Radix_heap
+
+// f in the upper half and the inverted g in the lower half, so ties on f go to the larger g
+uint64_t pq_binary_key(uint32_t f, uint32_t g)
+{
+    return ((uint64_t)f << 32) | (UINT32_MAX - g);
+}
+
+priority_queue_t *create_priority_queue(priority_queue_type_t type, uint32_t cellCount, uint32_t *slots)
+{
+    if (!cellCount || !slots)
+    {
+        return 0;
+    }
+
+    priority_queue_t *queue = malloc(sizeof(priority_queue_t));
+    if (!queue)
+    {
+        return 0;
+    }
+
+    memset(queue, 0, sizeof(priority_queue_t));
+    queue->type = type;
+    queue->cellCount = cellCount;
+    queue->slots = slots;
+
+    int32_t success = 1;
+    if (type == PQ_BUCKET_QUEUE || type == PQ_RADIX_HEAP)
+    {
+        queue->front = create_index_min_heap(cellCount, slots);
+        queue->keys = malloc(cellCount * sizeof(uint32_t));
+        queue->costs = malloc(cellCount * sizeof(uint32_t));
+        success = queue->front && queue->keys && queue->costs;
+    }
+
+    switch (type)
+    {
+        case PQ_BINARY_HEAP:
+            queue->heap = create_index_min_heap(cellCount, slots);
+            success = queue->heap != 0;
+            break;
+        case PQ_BUCKET_QUEUE:
+            queue->headCapacity = 64;
+            queue->heads = malloc(queue->headCapacity * sizeof(uint32_t));
+            queue->next = malloc(cellCount * sizeof(uint32_t));
+            queue->previous = malloc(cellCount * sizeof(uint32_t));
+            success = success && queue->heads && queue->next && queue->previous;
+            if (success)
+            {
+                memset(queue->heads, 0xFF, queue->headCapacity * sizeof(uint32_t));
+            }
+            break;
+        case PQ_RADIX_HEAP:
+            queue->positions = malloc(cellCount * sizeof(uint32_t));
+            success = success && queue->positions;
+            break;
+        default:
+            success = 0;
+            break;
+    }
+
+    if (!success)
+    {
+        dispose_priority_queue(queue);
+        return 0;
+    }
+
+    pq_clear(queue);
+    return queue;
+}
+
+void dispose_priority_queue(priority_queue_t *queue)
+{
+    if (queue)
+    {
+        dispose_index_min_heap(queue->heap);
+        dispose_index_min_heap(queue->front);
+        free(queue->keys);
+        free(queue->costs);
+        free(queue->heads);
+        free(queue->next);
+        free(queue->previous);
+        free(queue->positions);
+        for (uint32_t i = 0; i < PQ_RADIX_BUCKET_COUNT; i++)
+        {
+            free(queue->radixBuckets[i].cells);
+        }
+        free(queue);
+    }
+}
+
+void pq_clear(priority_queue_t *queue)
+{
+    if (!queue)
+    {
+        return;
+    }
+
+    switch (queue->type)
+    {
+        case PQ_BINARY_HEAP:
+            imh_clear(queue->heap);
+            break;
+        case PQ_BUCKET_QUEUE:
+            // searches that stop at the goal leave cells behind, the buckets are only empty when the front heap holds everything
+            if (queue->size > queue->front->size)
+            {
+                memset(queue->heads, 0xFF, queue->headCapacity * sizeof(uint32_t));
+            }
+            imh_clear(queue->front);
+            break;
+        case PQ_RADIX_HEAP:
+            for (uint32_t i = 0; i < PQ_RADIX_BUCKET_COUNT; i++)
+            {
+                queue->radixBuckets[i].size = 0;
+            }
+            imh_clear(queue->front);
+            break;
+    }
+
+    queue->size = 0;
+}
+
+int32_t pq_is_empty(priority_queue_t *queue)
+{
+    return !queue || queue->size == 0;
+}
+
+void pq_push_front(priority_queue_t *queue, uint32_t cell)
+{
+    imh_insert(queue->front, cell, pq_binary_key(queue->keys[cell], queue->costs[cell]));
+}
+
+// Bucket queue
+
+// Moves every waiting cell into the front heap and lets it take all later pushes, used when the f values are
+// spread too far for buckets or their memory runs out. The queue goes back to buckets once it has been emptied.
+void bucket_drain(priority_queue_t *queue)
+{
+    for (uint32_t i = 0; i < queue->headCapacity; i++)
+    {
+        for (uint32_t cell = queue->heads[i]; cell != PQ_EMPTY; cell = queue->next[cell])
+        {
+            pq_push_front(queue, cell);
+        }
+        queue->heads[i] = PQ_EMPTY;
+    }
+
+    queue->frontKey = UINT32_MAX;
+}
+
+// Widens the circular array until f fits behind frontKey, the lists keep their cells and only move to the
+// head of their f under the new mask
+void bucket_grow(priority_queue_t *queue, uint32_t f)
+{
+    uint32_t range = f - queue->frontKey;
+    uint32_t newCapacity = queue->headCapacity;
+    while (newCapacity < range && newCapacity < PQ_BUCKET_LIMIT)
+    {
+        newCapacity *= 2;
+    }
+
+    uint32_t *newHeads = newCapacity >= range ? malloc(newCapacity * sizeof(uint32_t)) : 0;
+    if (!newHeads)
+    {
+        bucket_drain(queue);
+        return;
+    }
+
+    memset(newHeads, 0xFF, newCapacity * sizeof(uint32_t));
+    for (uint32_t i = 0; i < queue->headCapacity; i++)
+    {
+        uint32_t head = queue->heads[i];
+        if (head != PQ_EMPTY)
+        {
+            newHeads[queue->keys[head] & (newCapacity - 1)] = head;
+        }
+    }
+
+    free(queue->heads);
+    queue->heads = newHeads;
+    queue->headCapacity = newCapacity;
+}
+
+void bucket_link(priority_queue_t *queue, uint32_t cell)
+{
+    uint32_t f = queue->keys[cell];
+    if (f - queue->frontKey > queue->headCapacity)
+    {
+        bucket_grow(queue, f);
+        if (f <= queue->frontKey)
+        {
+            pq_push_front(queue, cell);
+            return;
+        }
+    }
+
+    uint32_t *head = &queue->heads[f & (queue->headCapacity - 1)];
+    queue->slots[cell] = PQ_WAITING;
+    queue->previous[cell] = PQ_EMPTY;
+    queue->next[cell] = *head;
+    if (*head != PQ_EMPTY)
+    {
+        queue->previous[*head] = cell;
+    }
+    *head = cell;
+
+    if (f < queue->minBucket)
+    {
+        queue->minBucket = f;
+    }
+}
+
+void bucket_unlink(priority_queue_t *queue, uint32_t cell)
+{
+    if (queue->previous[cell] != PQ_EMPTY)
+    {
+        queue->next[queue->previous[cell]] = queue->next[cell];
+    }
+    else
+    {
+        queue->heads[queue->keys[cell] & (queue->headCapacity - 1)] = queue->next[cell];
+    }
+
+    if (queue->next[cell] != PQ_EMPTY)
+    {
+        queue->previous[queue->next[cell]] = queue->previous[cell];
+    }
+}
+
+// Moves the lowest non-empty bucket into the front heap, all buckets lie within headCapacity of frontKey
+// so the scan is bounded and every f maps to its own list
+void bucket_advance(priority_queue_t *queue)
+{
+    uint32_t f = queue->minBucket > queue->frontKey ? queue->minBucket : queue->frontKey + 1;
+    uint32_t mask = queue->headCapacity - 1;
+    while (queue->heads[f & mask] == PQ_EMPTY)
+    {
+        f++;
+    }
+
+    for (uint32_t cell = queue->heads[f & mask]; cell != PQ_EMPTY; cell = queue->next[cell])
+    {
+        pq_push_front(queue, cell);
+    }
+
+    queue->heads[f & mask] = PQ_EMPTY;
+    queue->frontKey = f;
+    queue->minBucket = f + 1;
+}
+
+// Radix heap
+
+uint32_t radix_bucket_index(uint32_t key, uint32_t lastKey)
+{
+    if (key == lastKey)
+    {
+        return 0;
+    }
+
+    return 32 - __builtin_clz(key ^ lastKey);
+}
+
+int32_t radix_append(priority_queue_t *queue, uint32_t cell)
+{
+    uint32_t index = radix_bucket_index(queue->keys[cell], queue->frontKey);
+    pq_bucket_t *bucket = &queue->radixBuckets[index];
+    if (bucket->size == bucket->capacity)
+    {
+        uint32_t newCapacity = bucket->capacity ? bucket->capacity * 2 : 64;
+        uint32_t *newCells = realloc(bucket->cells, newCapacity * sizeof(uint32_t));
+        if (!newCells)
+        {
+            return 0;
+        }
+        bucket->cells = newCells;
+        bucket->capacity = newCapacity;
+    }
+
+    queue->slots[cell] = PQ_WAITING;
+    queue->positions[cell] = bucket->size;
+    bucket->cells[bucket->size++] = cell;
+    return 1;
+}
+
+void radix_remove(priority_queue_t *queue, uint32_t cell)
+{
+    // refills keep the bucket of every cell they do not touch, so the index can be derived again
+    pq_bucket_t *bucket = &queue->radixBuckets[radix_bucket_index(queue->keys[cell], queue->frontKey)];
+    uint32_t position = queue->positions[cell];
+    uint32_t last = bucket->cells[--bucket->size];
+    bucket->cells[position] = last;
+    queue->positions[last] = position;
+}
+
+// Same fallback as bucket_drain for when a radix bucket cannot grow while it is being spread out
+void radix_drain(priority_queue_t *queue)
+{
+    for (uint32_t i = 0; i < PQ_RADIX_BUCKET_COUNT; i++)
+    {
+        pq_bucket_t *bucket = &queue->radixBuckets[i];
+        for (uint32_t j = 0; j < bucket->size; j++)
+        {
+            pq_push_front(queue, bucket->cells[j]);
+        }
+        bucket->size = 0;
+    }
+
+    queue->frontKey = UINT32_MAX;
+}
+
+// Makes the smallest key of the first non-empty bucket the new frontKey, its cells go to the front heap and
+// the rest of that bucket is spread over the lower ones. Every cell only moves down so the total work stays
+// O(log C) per cell.
+void radix_refill(priority_queue_t *queue)
+{
+    uint32_t index = 1;
+    while (index < PQ_RADIX_BUCKET_COUNT && queue->radixBuckets[index].size == 0)
+    {
+        index++;
+    }
+
+    if (index == PQ_RADIX_BUCKET_COUNT)
+    {
+        return;
+    }
+
+    pq_bucket_t *bucket = &queue->radixBuckets[index];
+    uint32_t minKey = UINT32_MAX;
+    for (uint32_t i = 0; i < bucket->size; i++)
+    {
+        if (queue->keys[bucket->cells[i]] < minKey)
+        {
+            minKey = queue->keys[bucket->cells[i]];
+        }
+    }
+
+    queue->frontKey = minKey;
+
+    // cells always land in buckets below index, so the ones still to be moved cannot be overwritten
+    int32_t success = 1;
+    uint32_t count = bucket->size;
+    bucket->size = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t cell = bucket->cells[i];
+        if (queue->keys[cell] == minKey || !success || !(success = radix_append(queue, cell)))
+        {
+            pq_push_front(queue, cell);
+        }
+    }
+
+    if (!success)
+    {
+        radix_drain(queue);
+    }
+}
+
+// Queues a cell of the bucket queue or radix heap whose key and cost are set
+int32_t pq_place(priority_queue_t *queue, uint32_t cell)
+{
+    if (queue->keys[cell] <= queue->frontKey)
+    {
+        pq_push_front(queue, cell);
+        return 1;
+    }
+
+    if (queue->type == PQ_BUCKET_QUEUE)
+    {
+        bucket_link(queue, cell);
+        return 1;
+    }
+
+    return radix_append(queue, cell);
+}
+
+// Returns 0 if the cell could not be queued
+int32_t pq_push(priority_queue_t *queue, uint32_t cell, uint32_t f, uint32_t g)
+{
+    if (!queue || cell >= queue->cellCount)
+    {
+        return 0;
+    }
+
+    if (queue->type == PQ_BINARY_HEAP)
+    {
+        imh_insert(queue->heap, cell, pq_binary_key(f, g));
+    }
+    else
+    {
+        // an empty queue starts over at the first key, which also ends a fallback to the front heap
+        if (queue->size == 0)
+        {
+            queue->frontKey = f;
+            queue->minBucket = UINT32_MAX;
+        }
+
+        queue->keys[cell] = f;
+        queue->costs[cell] = g;
+        if (!pq_place(queue, cell))
+        {
+            return 0;
+        }
+    }
+
+    queue->size++;
+    return 1;
+}
+
+// Refills an empty front heap from the lowest f that is waiting
+void pq_advance(priority_queue_t *queue)
+{
+    if (queue->front->size > 0)
+    {
+        return;
+    }
+
+    if (queue->type == PQ_BUCKET_QUEUE)
+    {
+        bucket_advance(queue);
+    }
+    else
+    {
+        radix_refill(queue);
+    }
+}
+
+uint32_t pq_pop(priority_queue_t *queue)
+{
+    if (pq_is_empty(queue))
+    {
+        return PQ_EMPTY;
+    }
+
+    uint32_t cell = PQ_EMPTY;
+    if (queue->type == PQ_BINARY_HEAP)
+    {
+        cell = imh_extract_min(queue->heap);
+    }
+    else
+    {
+        pq_advance(queue);
+        cell = imh_extract_min(queue->front);
+    }
+
+    queue->size--;
+    return cell;
+}
+
+// Smallest f in the queue without removing it, UINT32_MAX when empty
+uint32_t pq_min_f(priority_queue_t *queue)
+{
+    if (pq_is_empty(queue))
+    {
+        return UINT32_MAX;
+    }
+
+    if (queue->type == PQ_BINARY_HEAP)
+    {
+        return imh_min_key(queue->heap) >> 32;
+    }
+
+    pq_advance(queue);
+    return imh_min_key(queue->front) >> 32;
+}
+
+// Returns 0 if the cell fell out of the queue because its new place could not be allocated
+int32_t pq_decrease_key(priority_queue_t *queue, uint32_t cell, uint32_t f, uint32_t g)
+{
+    if (!queue || cell >= queue->cellCount)
+    {
+        return 0;
+    }
+
+    if (queue->type == PQ_BINARY_HEAP)
+    {
+        imh_decrease_key(queue->heap, cell, pq_binary_key(f, g));
+        return 1;
+    }
+
+    if (imh_contains(queue->front, cell))
+    {
+        imh_decrease_key(queue->front, cell, pq_binary_key(f, g));
+        return 1;
+    }
+
+    if (f > queue->keys[cell] || (f == queue->keys[cell] && g <= queue->costs[cell]))
+    {
+        return 1;
+    }
+
+    if (queue->type == PQ_BUCKET_QUEUE)
+    {
+        bucket_unlink(queue, cell);
+    }
+    else
+    {
+        radix_remove(queue, cell);
+    }
+
+    queue->keys[cell] = f;
+    queue->costs[cell] = g;
+    if (!pq_place(queue, cell))
+    {
+        queue->size--;
+        return 0;
+    }
+
+    return 1;
+}
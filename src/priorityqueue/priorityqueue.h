@@ -0,0 +1,63 @@
+#ifndef __PRIORITYQUEUE_H__
+#define __PRIORITYQUEUE_H__
+
+#include "../minheap/minheap.h"
+
+#define PQ_EMPTY UINT32_MAX
+#define PQ_WAITING (UINT32_MAX - 1) // slot of cells the bucket queue or radix heap keeps outside its front heap
+#define PQ_RADIX_BUCKET_COUNT 33
+#define PQ_BUCKET_LIMIT (1 << 16) // widest f range the bucket queue keeps in buckets before it falls back to its heap
+
+typedef enum {
+    PQ_BINARY_HEAP,
+    PQ_BUCKET_QUEUE,
+    PQ_RADIX_HEAP
+} priority_queue_type_t;
+
+typedef struct {
+    uint32_t *cells;
+    uint32_t size;
+    uint32_t capacity;
+} pq_bucket_t;
+
+// Priority queue over cell indices ordered by f, ties go to the larger g.
+// slots is owned by the caller and holds the heap position of every queued cell, or PQ_WAITING,
+// it is only meaningful for cells that are currently queued.
+typedef struct {
+    priority_queue_type_t type;
+    uint32_t cellCount;
+    uint32_t size;
+    uint32_t *slots;
+
+    // binary heap
+    index_min_heap_t *heap;
+
+    // The bucket queue and the radix heap only sort by f. Cells with f up to frontKey sit in the front heap
+    // which orders them like the binary heap, the ones above wait unordered until their f is the lowest.
+    index_min_heap_t *front;
+    uint32_t frontKey;
+    uint32_t *keys; // f of waiting cells
+    uint32_t *costs; // g of waiting cells
+
+    // bucket queue, one list per f value in a circular array covering frontKey + 1 to frontKey + headCapacity
+    uint32_t *heads;
+    uint32_t *next;
+    uint32_t *previous;
+    uint32_t headCapacity;
+    uint32_t minBucket;
+
+    // radix heap, frontKey takes the role of the last extracted key
+    uint32_t *positions;
+    pq_bucket_t radixBuckets[PQ_RADIX_BUCKET_COUNT];
+} priority_queue_t;
+
+priority_queue_t *create_priority_queue(priority_queue_type_t type, uint32_t cellCount, uint32_t *slots);
+void dispose_priority_queue(priority_queue_t *queue);
+void pq_clear(priority_queue_t *queue);
+int32_t pq_is_empty(priority_queue_t *queue);
+int32_t pq_push(priority_queue_t *queue, uint32_t cell, uint32_t f, uint32_t g);
+uint32_t pq_pop(priority_queue_t *queue);
+uint32_t pq_min_f(priority_queue_t *queue);
+int32_t pq_decrease_key(priority_queue_t *queue, uint32_t cell, uint32_t f, uint32_t g);
+
+#endif
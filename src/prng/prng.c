@@ -0,0 +1,100 @@
+#include "./prng.h"
+
+// Implementation details from https://prng.di.unimi.it/xoshiro256starstar.c and https://prng.di.unimi.it/splitmix64.c
+
+uint64_t rotate_left(uint64_t value, int32_t shift)
+{
+    return (value << shift) | (value >> (64 - shift));
+}
+
+// Expands one 64-bit seed into the whole state with splitmix64, which never leaves it all zero
+void prng_seed(prng_t *prng, uint64_t seed)
+{
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        prng->state[i] = z ^ (z >> 31);
+    }
+}
+
+uint64_t prng_next(prng_t *prng)
+{
+    uint64_t *s = prng->state;
+    uint64_t result = rotate_left(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotate_left(s[3], 45);
+
+    return result;
+}
+
+// Advances the generator by 2^128 draws
+void prng_jump(prng_t *prng)
+{
+    static const uint64_t jump[4] = {0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull};
+
+    uint64_t s[4] = {0, 0, 0, 0};
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        for (uint32_t bit = 0; bit < 64; bit++)
+        {
+            if (jump[i] & ((uint64_t)1 << bit))
+            {
+                s[0] ^= prng->state[0];
+                s[1] ^= prng->state[1];
+                s[2] ^= prng->state[2];
+                s[3] ^= prng->state[3];
+            }
+            prng_next(prng);
+        }
+    }
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        prng->state[i] = s[i];
+    }
+}
+
+// Returns a generator for the current stream and moves this one on to the next, so streams handed out one after
+// another never overlap
+prng_t prng_split(prng_t *prng)
+{
+    prng_t stream = *prng;
+    prng_jump(prng);
+    return stream;
+}
+
+// Uniform in [0, bound) without the bias of %, Lemire's multiply and reject method. Returns 0 for a bound of 0.
+uint32_t prng_below(prng_t *prng, uint32_t bound)
+{
+    uint64_t product = (prng_next(prng) >> 32) * bound;
+    uint32_t low = (uint32_t)product;
+    if (low < bound)
+    {
+        uint32_t threshold = -bound % bound;
+        while (low < threshold)
+        {
+            product = (prng_next(prng) >> 32) * bound;
+            low = (uint32_t)product;
+        }
+    }
+
+    return product >> 32;
+}
+
+// Uniform in [min, max], both included
+uint32_t prng_range(prng_t *prng, uint32_t min, uint32_t max)
+{
+    if (min == 0 && max == UINT32_MAX)
+    {
+        return prng_next(prng) >> 32;
+    }
+    return min + prng_below(prng, max - min + 1);
+}
@@ -0,0 +1,19 @@
+#ifndef __PRNG_H__
+#define __PRNG_H__
+
+#include <stdint.h>
+
+// xoshiro256** by Blackman and Vigna. The state is a plain value, so every thread or job owns its own generator and
+// the same seed always produces the same sequence. prng_split hands out streams 2^128 draws apart.
+typedef struct {
+    uint64_t state[4];
+} prng_t;
+
+void prng_seed(prng_t *prng, uint64_t seed);
+uint64_t prng_next(prng_t *prng);
+void prng_jump(prng_t *prng);
+prng_t prng_split(prng_t *prng);
+uint32_t prng_below(prng_t *prng, uint32_t bound);
+uint32_t prng_range(prng_t *prng, uint32_t min, uint32_t max);
+
+#endif
@@ -50,6 +50,17 @@ void dispose_queue(queue_t *queue)
     free(queue);
 }
 
+void clear_queue(queue_t *queue)
+{
+    if (queue == 0)
+    {
+        return;
+    }
+
+    queue->size = 0;
+    queue->front = 0;
+    queue->rear = -1;
+}
 
 int enqueue(queue_t *queue, int x, int y)
 {
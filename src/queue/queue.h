@@ -19,6 +19,7 @@ typedef struct {
 
 queue_t *create_queue(uint32_t capacity);
 void dispose_queue(queue_t *queue);
+void clear_queue(queue_t *queue);
 
 int enqueue(queue_t *queue, int x, int y);
 queue_node_t dequeue(queue_t *queue);
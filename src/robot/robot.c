@@ -65,7 +65,7 @@ int atMarker(robot_t *robot)
 {
     if (validate_robot(robot))
     {
-        return get_tile(robot->arena, robot->x, robot->y) == 0x02;
+        return arena_is_marker(robot->arena, robot->x, robot->y);
     }
     
     return 0;
@@ -113,6 +113,12 @@ int canMoveForward(robot_t *robot)
         return 0;
     }
 
+    if (robot->arena->layout == ARENA_LAYOUT_BORDERED)
+    {
+        // the tile ahead is at worst a sentinel, so no range check is needed
+        return arena_walkable_at(robot->arena, arena_cell_index(robot->arena, robot->x, robot->y) + arena_neighbor_offset(robot->arena, robot->direction));
+    }
+
     int32_t x_shift = (robot->direction == 1) - (robot->direction == 3);
     int32_t y_shift = (robot->direction == 2) - (robot->direction == 0);
 
@@ -124,9 +130,7 @@ int canMoveForward(robot_t *robot)
         return 0;
     }
 
-    uint8_t result = get_tile(robot->arena, new_x, new_y);
-
-    return result == 0x00 || result == 0x02;
+    return arena_is_passable(robot->arena, new_x, new_y);
 }
 
 void forward(robot_t *robot)
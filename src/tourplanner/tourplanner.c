@@ -0,0 +1,377 @@
+#include "./tourplanner.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Tour improvement heuristics from https://en.wikipedia.org/wiki/2-opt and https://en.wikipedia.org/wiki/Held%E2%80%93Karp_algorithm
+
+int64_t tour_distance(tour_t *tour, uint32_t from, uint32_t to)
+{
+    uint32_t distance = tour->distances[from * tour->pointCount + to];
+    // unreachable legs are heavily penalised instead of overflowing the sums
+    return distance == PF_UNREACHABLE ? (int64_t)UINT32_MAX : distance;
+}
+
+int64_t tour_sequence_length(tour_t *tour, uint32_t *sequence)
+{
+    int64_t length = 0;
+    for (uint32_t i = 0; i + 1 < tour->pointCount; i++)
+    {
+        length += tour_distance(tour, sequence[i], sequence[i + 1]);
+    }
+    return length;
+}
+
+uint32_t tour_clamp_length(int64_t length)
+{
+    return length >= UINT32_MAX ? PF_UNREACHABLE : (uint32_t)length;
+}
+
+void dispose_tour(tour_t *tour)
+{
+    if (tour)
+    {
+        free(tour->pointsX);
+        free(tour->pointsY);
+        free(tour->distances);
+        free(tour->sequence);
+        free(tour);
+    }
+}
+
+uint32_t tour_marker_count(tour_t *tour)
+{
+    return tour ? tour->pointCount - 2 : 0;
+}
+
+// Greedy construction, always walks to the closest unvisited marker, this is also what the solver did without a plan
+void tour_nearest_neighbor(tour_t *tour)
+{
+    uint32_t last = tour->pointCount - 1;
+    uint8_t *used = calloc(tour->pointCount, sizeof(uint8_t));
+    if (!used)
+    {
+        for (uint32_t i = 0; i < tour->pointCount; i++)
+        {
+            tour->sequence[i] = i;
+        }
+        return;
+    }
+
+    tour->sequence[0] = 0;
+    tour->sequence[last] = last;
+    for (uint32_t i = 1; i < last; i++)
+    {
+        uint32_t current = tour->sequence[i - 1];
+        uint32_t best = 0;
+        int64_t bestDistance = INT64_MAX;
+        for (uint32_t j = 1; j < last; j++)
+        {
+            if (!used[j] && tour_distance(tour, current, j) < bestDistance)
+            {
+                bestDistance = tour_distance(tour, current, j);
+                best = j;
+            }
+        }
+        used[best] = 1;
+        tour->sequence[i] = best;
+    }
+
+    free(used);
+}
+
+// Reverses interior segments while that shortens the path, the endpoints stay fixed at the start and home
+int32_t tour_two_opt(tour_t *tour)
+{
+    uint32_t *s = tour->sequence;
+    uint32_t last = tour->pointCount - 1;
+    int32_t improved = 0;
+
+    for (uint32_t i = 1; i + 1 < last; i++)
+    {
+        for (uint32_t j = i + 1; j < last; j++)
+        {
+            int64_t delta = tour_distance(tour, s[i - 1], s[j]) + tour_distance(tour, s[i], s[j + 1]) -
+                            tour_distance(tour, s[i - 1], s[i]) - tour_distance(tour, s[j], s[j + 1]);
+            if (delta < 0)
+            {
+                for (uint32_t a = i, b = j; a < b; a++, b--)
+                {
+                    uint32_t temp = s[a];
+                    s[a] = s[b];
+                    s[b] = temp;
+                }
+                improved = 1;
+            }
+        }
+    }
+
+    return improved;
+}
+
+// Moves a segment of up to 3 markers to the best other position, optionally reversed
+int32_t tour_or_opt(tour_t *tour, uint32_t *scratch)
+{
+    uint32_t *s = tour->sequence;
+    uint32_t n = tour->pointCount;
+    int32_t improved = 0;
+
+    for (uint32_t length = 1; length <= 3; length++)
+    {
+        for (uint32_t i = 1; i + length < n; i++)
+        {
+            uint32_t first = s[i];
+            uint32_t end = s[i + length - 1];
+            int64_t removeGain = tour_distance(tour, s[i - 1], first) + tour_distance(tour, end, s[i + length]) -
+                                 tour_distance(tour, s[i - 1], s[i + length]);
+
+            int64_t bestDelta = 0;
+            uint32_t bestK = 0;
+            int32_t bestReversed = 0;
+            for (uint32_t k = 0; k + 1 < n; k++)
+            {
+                if (k + 1 >= i && k <= i + length - 1) // edges touching the segment
+                {
+                    continue;
+                }
+
+                int64_t edge = tour_distance(tour, s[k], s[k + 1]);
+                int64_t forward = tour_distance(tour, s[k], first) + tour_distance(tour, end, s[k + 1]) - edge - removeGain;
+                int64_t reversed = tour_distance(tour, s[k], end) + tour_distance(tour, first, s[k + 1]) - edge - removeGain;
+                if (forward < bestDelta)
+                {
+                    bestDelta = forward;
+                    bestK = k;
+                    bestReversed = 0;
+                }
+                if (reversed < bestDelta)
+                {
+                    bestDelta = reversed;
+                    bestK = k;
+                    bestReversed = 1;
+                }
+            }
+
+            if (bestDelta >= 0)
+            {
+                continue;
+            }
+
+            // rebuild the sequence with the segment inserted after position bestK
+            uint32_t count = 0;
+            for (uint32_t k = 0; k < n; k++)
+            {
+                if (k >= i && k < i + length)
+                {
+                    continue;
+                }
+
+                scratch[count++] = s[k];
+                if (k == bestK)
+                {
+                    for (uint32_t m = 0; m < length; m++)
+                    {
+                        scratch[count++] = bestReversed ? s[i + length - 1 - m] : s[i + m];
+                    }
+                }
+            }
+
+            memcpy(s, scratch, n * sizeof(uint32_t));
+            improved = 1;
+        }
+    }
+
+    return improved;
+}
+
+// Exact dynamic programming over subsets, only used while 2^markers stays small
+int32_t tour_held_karp(tour_t *tour)
+{
+    uint32_t markerCount = tour_marker_count(tour);
+    uint32_t home = tour->pointCount - 1;
+    if (markerCount == 0)
+    {
+        tour->sequence[0] = 0;
+        tour->sequence[1] = home;
+        return 1;
+    }
+
+    uint32_t subsetCount = 1u << markerCount;
+    int64_t *cost = malloc((size_t)subsetCount * markerCount * sizeof(int64_t));
+    uint8_t *previous = malloc((size_t)subsetCount * markerCount * sizeof(uint8_t));
+    if (!cost || !previous)
+    {
+        free(cost);
+        free(previous);
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < subsetCount * markerCount; i++)
+    {
+        cost[i] = INT64_MAX;
+    }
+
+    for (uint32_t j = 0; j < markerCount; j++)
+    {
+        cost[(1u << j) * markerCount + j] = tour_distance(tour, 0, j + 1);
+        previous[(1u << j) * markerCount + j] = UINT8_MAX;
+    }
+
+    for (uint32_t subset = 1; subset < subsetCount; subset++)
+    {
+        for (uint32_t j = 0; j < markerCount; j++)
+        {
+            int64_t current = cost[subset * markerCount + j];
+            if (!(subset & (1u << j)) || current == INT64_MAX)
+            {
+                continue;
+            }
+
+            for (uint32_t k = 0; k < markerCount; k++)
+            {
+                if (subset & (1u << k))
+                {
+                    continue;
+                }
+
+                uint32_t next = subset | (1u << k);
+                int64_t candidate = current + tour_distance(tour, j + 1, k + 1);
+                if (candidate < cost[next * markerCount + k])
+                {
+                    cost[next * markerCount + k] = candidate;
+                    previous[next * markerCount + k] = j;
+                }
+            }
+        }
+    }
+
+    uint32_t full = subsetCount - 1;
+    uint32_t bestLast = 0;
+    int64_t bestCost = INT64_MAX;
+    for (uint32_t j = 0; j < markerCount; j++)
+    {
+        int64_t candidate = cost[full * markerCount + j] + tour_distance(tour, j + 1, home);
+        if (candidate < bestCost)
+        {
+            bestCost = candidate;
+            bestLast = j;
+        }
+    }
+
+    tour->sequence[0] = 0;
+    tour->sequence[home] = home;
+    uint32_t subset = full;
+    uint32_t current = bestLast;
+    for (uint32_t position = markerCount; position >= 1; position--)
+    {
+        tour->sequence[position] = current + 1;
+        uint32_t before = previous[subset * markerCount + current];
+        subset &= ~(1u << current);
+        current = before;
+    }
+
+    free(cost);
+    free(previous);
+    return 1;
+}
+
+tour_t *plan_marker_tour(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint32_t homeX, uint32_t homeY, uint32_t markerCount, uint32_t *markersX, uint32_t *markersY)
+{
+    if (!pathfinder || (markerCount && (!markersX || !markersY)))
+    {
+        return 0;
+    }
+
+    tour_t *tour = malloc(sizeof(tour_t));
+    if (!tour)
+    {
+        return 0;
+    }
+
+    memset(tour, 0, sizeof(tour_t));
+    tour->pointsX = malloc((markerCount + 2) * sizeof(uint32_t));
+    tour->pointsY = malloc((markerCount + 2) * sizeof(uint32_t));
+    if (!tour->pointsX || !tour->pointsY)
+    {
+        dispose_tour(tour);
+        return 0;
+    }
+
+    // only live markers reachable from the start take part in the tour
+    if (!pf_compute_distance_field(pathfinder, startX, startY))
+    {
+        dispose_tour(tour);
+        return 0;
+    }
+
+    uint32_t count = 0;
+    tour->pointsX[count] = startX;
+    tour->pointsY[count] = startY;
+    count++;
+    for (uint32_t i = 0; i < markerCount; i++)
+    {
+        if (get_tile(pathfinder->arena, markersX[i], markersY[i]) == 0x02 && pf_get_distance(pathfinder, markersX[i], markersY[i]) != PF_UNREACHABLE)
+        {
+            tour->pointsX[count] = markersX[i];
+            tour->pointsY[count] = markersY[i];
+            count++;
+        }
+    }
+    tour->pointsX[count] = homeX;
+    tour->pointsY[count] = homeY;
+    count++;
+    tour->pointCount = count;
+
+    if (tour_marker_count(tour) > TOUR_MAX_MARKERS)
+    {
+        dispose_tour(tour);
+        return 0;
+    }
+
+    tour->distances = malloc(count * count * sizeof(uint32_t));
+    tour->sequence = malloc(count * sizeof(uint32_t));
+    uint32_t *scratch = malloc(count * sizeof(uint32_t));
+    if (!tour->distances || !tour->sequence || !scratch)
+    {
+        free(scratch);
+        dispose_tour(tour);
+        return 0;
+    }
+
+    // one distance field per point except home, walking distances are symmetric so home's row is mirrored
+    uint32_t home = count - 1;
+    for (uint32_t i = 0; i < home; i++)
+    {
+        if (i > 0)
+        {
+            pf_compute_distance_field(pathfinder, tour->pointsX[i], tour->pointsY[i]);
+        }
+
+        for (uint32_t j = 0; j < count; j++)
+        {
+            uint32_t distance = pf_get_distance(pathfinder, tour->pointsX[j], tour->pointsY[j]);
+            tour->distances[i * count + j] = distance;
+            if (j == home)
+            {
+                tour->distances[home * count + i] = distance;
+            }
+        }
+    }
+    tour->distances[home * count + home] = 0;
+
+    tour_nearest_neighbor(tour);
+    tour->greedyLength = tour_clamp_length(tour_sequence_length(tour, tour->sequence));
+
+    if (tour_marker_count(tour) > TOUR_HELD_KARP_MAX_MARKERS || !tour_held_karp(tour))
+    {
+        uint32_t rounds = 0;
+        while ((tour_two_opt(tour) | tour_or_opt(tour, scratch)) && rounds < 1000)
+        {
+            rounds++;
+        }
+    }
+
+    tour->plannedLength = tour_clamp_length(tour_sequence_length(tour, tour->sequence));
+    free(scratch);
+
+    return tour;
+}
@@ -0,0 +1,25 @@
+#ifndef __TOURPLANNER_H__
+#define __TOURPLANNER_H__
+
+#include "../pathfinder/pathfinder.h"
+
+#define TOUR_MAX_MARKERS 512
+#define TOUR_HELD_KARP_MAX_MARKERS 12
+
+// Order in which to visit the markers on the way from the start to home.
+// Point 0 is the start, points 1..markerCount are the reachable markers and the last point is home.
+typedef struct {
+    uint32_t pointCount;
+    uint32_t *pointsX;
+    uint32_t *pointsY;
+    uint32_t *distances;
+    uint32_t *sequence;
+    uint32_t plannedLength;
+    uint32_t greedyLength;
+} tour_t;
+
+tour_t *plan_marker_tour(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint32_t homeX, uint32_t homeY, uint32_t markerCount, uint32_t *markersX, uint32_t *markersY);
+void dispose_tour(tour_t *tour);
+uint32_t tour_marker_count(tour_t *tour);
+
+#endif
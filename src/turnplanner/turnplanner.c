@@ -0,0 +1,260 @@
+#include "./turnplanner.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const int32_t headingX[4] = {0, 1, 0, -1};
+static const int32_t headingY[4] = {-1, 0, 1, 0};
+
+turn_planner_t *create_turn_planner(uint32_t cellCount, priority_queue_type_t queueType)
+{
+    if (!cellCount || cellCount > UINT32_MAX / 4)
+    {
+        return 0;
+    }
+
+    turn_planner_t *planner = malloc(sizeof(turn_planner_t));
+    if (!planner)
+    {
+        return 0;
+    }
+
+    memset(planner, 0, sizeof(turn_planner_t));
+    planner->stateCount = cellCount * 4;
+    planner->generation = 1;
+    planner->g = malloc(planner->stateCount * sizeof(uint32_t));
+    planner->parent = malloc(planner->stateCount * sizeof(uint32_t));
+    planner->slot = malloc(planner->stateCount * sizeof(uint32_t));
+    planner->stamp = calloc(planner->stateCount, sizeof(uint32_t));
+    if (!planner->g || !planner->parent || !planner->slot || !planner->stamp)
+    {
+        dispose_turn_planner(planner);
+        return 0;
+    }
+
+    planner->openList = create_priority_queue(queueType, planner->stateCount, planner->slot);
+    if (!planner->openList)
+    {
+        dispose_turn_planner(planner);
+        return 0;
+    }
+
+    return planner;
+}
+
+void dispose_turn_planner(turn_planner_t *planner)
+{
+    if (planner)
+    {
+        dispose_priority_queue(planner->openList);
+        free(planner->g);
+        free(planner->parent);
+        free(planner->slot);
+        free(planner->stamp);
+        free(planner);
+    }
+}
+
+// Lower bound on the quarter turns needed to reach the goal from (x, y) facing heading
+uint32_t minimum_turns(int32_t x, int32_t y, uint8_t heading, int32_t goalX, int32_t goalY)
+{
+    int32_t needX = (goalX > x) - (goalX < x);
+    int32_t needY = (goalY > y) - (goalY < y);
+    int32_t alongX = needX != 0 && headingX[heading] == needX;
+    int32_t alongY = needY != 0 && headingY[heading] == needY;
+
+    if (needX == 0 && needY == 0)
+    {
+        return 0;
+    }
+
+    if (needX != 0 && needY != 0)
+    {
+        return (alongX || alongY) ? 1 : 2;
+    }
+
+    if (alongX || alongY)
+    {
+        return 0;
+    }
+
+    // facing straight away from the goal needs a u-turn
+    int32_t away = (needX != 0 && headingX[heading] == -needX) || (needY != 0 && headingY[heading] == -needY);
+    return away ? 2 : 1;
+}
+
+// Largest forward or turn cost for which g and f of every state stay within 32 bits on this arena. A plan passes
+// each (cell, heading) state at most once and the heuristic adds at most width + height moves and two turns.
+uint32_t turn_max_action_cost(pathfinder_t *pathfinder)
+{
+    uint64_t steps = 4 * (uint64_t)pathfinder->cellCount + pathfinder->width + pathfinder->height + 3;
+    return steps >= UINT32_MAX ? 1 : (uint32_t)(UINT32_MAX / steps);
+}
+
+uint32_t turn_heuristic(pathfinder_t *pathfinder, uint32_t state, uint32_t goalX, uint32_t goalY)
+{
+    uint32_t cell = state / 4;
+    int32_t x = arena_cell_x(pathfinder->arena, cell);
+    int32_t y = arena_cell_y(pathfinder->arena, cell);
+    return heuristic(x, y, goalX, goalY) * pathfinder->forwardCost + minimum_turns(x, y, state % 4, goalX, goalY) * pathfinder->turnCost;
+}
+
+// Returns 0 when the open list ran out of memory and the search has to stop
+int32_t relax_state(pathfinder_t *pathfinder, turn_planner_t *planner, uint32_t current, uint32_t next, uint32_t cost, uint32_t goalX, uint32_t goalY)
+{
+    int32_t visited = planner->stamp[next] == planner->generation;
+    if (visited && planner->slot[next] == PF_CLOSED)
+    {
+        return 1;
+    }
+
+    uint32_t g = planner->g[current] + cost;
+    uint32_t f = g + turn_heuristic(pathfinder, next, goalX, goalY);
+    if (!visited)
+    {
+        planner->stamp[next] = planner->generation;
+        planner->g[next] = g;
+        planner->parent[next] = current;
+        pathfinder->stats.heapOperations++;
+        if (!pq_push(planner->openList, next, f, g))
+        {
+            pathfinder->outOfMemory = 1;
+            return 0;
+        }
+    }
+    else if (g < planner->g[next])
+    {
+        planner->g[next] = g;
+        planner->parent[next] = current;
+        pathfinder->stats.heapOperations++;
+        if (!pq_decrease_key(planner->openList, next, f, g))
+        {
+            pathfinder->outOfMemory = 1;
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+// Collapses the state chain into one node per visited cell, turns in place do not add nodes
+node_t *build_turn_path(pathfinder_t *pathfinder, turn_planner_t *planner, uint32_t goalState, uint32_t goalX, uint32_t goalY)
+{
+    uint32_t length = 1;
+    for (uint32_t state = goalState; planner->parent[state] != PF_NO_PARENT; state = planner->parent[state])
+    {
+        if (planner->parent[state] / 4 != state / 4)
+        {
+            length++;
+        }
+    }
+
+    node_t *block = malloc(length * sizeof(node_t));
+    if (!block)
+    {
+        return 0;
+    }
+
+    uint32_t state = goalState;
+    for (int32_t i = length - 1; i >= 0; i--)
+    {
+        uint32_t cell = state / 4;
+        node_t *node = &block[i];
+        node->x = arena_cell_x(pathfinder->arena, cell);
+        node->y = arena_cell_y(pathfinder->arena, cell);
+        node->g = planner->g[state];
+        node->h = heuristic(node->x, node->y, goalX, goalY);
+        node->f = node->g + node->h;
+        node->heapIndex = -1;
+        node->parent = i > 0 ? &block[i - 1] : 0;
+
+        while (planner->parent[state] != PF_NO_PARENT && planner->parent[state] / 4 == cell)
+        {
+            state = planner->parent[state];
+        }
+        if (planner->parent[state] != PF_NO_PARENT)
+        {
+            state = planner->parent[state];
+        }
+    }
+
+    return &block[length - 1];
+}
+
+// A* over (x, y, heading) that minimises forwardCost per step plus turnCost per quarter turn,
+// which matches the left/right/forward calls move_robot_in_directions will make for the returned path
+node_t *turn_aware_search(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint8_t startHeading, uint32_t goalX, uint32_t goalY)
+{
+    if (!pathfinder || startHeading > 3 || startX >= pathfinder->width || startY >= pathfinder->height || goalX >= pathfinder->width || goalY >= pathfinder->height)
+    {
+        return 0;
+    }
+
+    // larger costs would wrap g around and the search would no longer find the cheapest plan
+    uint32_t maxCost = turn_max_action_cost(pathfinder);
+    if (pathfinder->forwardCost > maxCost || pathfinder->turnCost > maxCost)
+    {
+        return 0;
+    }
+
+    if (!pathfinder->turnPlanner)
+    {
+        pathfinder->turnPlanner = create_turn_planner(pathfinder->cellCount, pathfinder->openList->type);
+        if (!pathfinder->turnPlanner)
+        {
+            return 0;
+        }
+    }
+
+    turn_planner_t *planner = pathfinder->turnPlanner;
+    planner->generation++;
+    if (planner->generation == 0)
+    {
+        memset(planner->stamp, 0, planner->stateCount * sizeof(uint32_t));
+        planner->generation = 1;
+    }
+    pq_clear(planner->openList);
+    pathfinder->outOfMemory = 0;
+
+    uint32_t startState = arena_cell_index(pathfinder->arena, startX, startY) * 4 + startHeading;
+    uint32_t goalCell = arena_cell_index(pathfinder->arena, goalX, goalY);
+
+    planner->stamp[startState] = planner->generation;
+    planner->g[startState] = 0;
+    planner->parent[startState] = PF_NO_PARENT;
+    pathfinder->stats.heapOperations++;
+    if (!pq_push(planner->openList, startState, turn_heuristic(pathfinder, startState, goalX, goalY), 0))
+    {
+        pathfinder->outOfMemory = 1;
+        return 0;
+    }
+
+    while (!pq_is_empty(planner->openList))
+    {
+        uint32_t current = pq_pop(planner->openList);
+        planner->slot[current] = PF_CLOSED;
+        pathfinder->stats.heapOperations++;
+        pathfinder->stats.expandedNodes++;
+
+        uint32_t cell = current / 4;
+        uint8_t heading = current % 4;
+        if (cell == goalCell)
+        {
+            return build_turn_path(pathfinder, planner, current, goalX, goalY);
+        }
+
+        if (!relax_state(pathfinder, planner, current, cell * 4 + (heading + 1) % 4, pathfinder->turnCost, goalX, goalY) ||
+            !relax_state(pathfinder, planner, current, cell * 4 + (heading + 3) % 4, pathfinder->turnCost, goalX, goalY))
+        {
+            return 0;
+        }
+
+        int32_t nx = arena_cell_x(pathfinder->arena, cell) + headingX[heading];
+        int32_t ny = arena_cell_y(pathfinder->arena, cell) + headingY[heading];
+        if (pf_is_walkable(pathfinder, nx, ny) && !relax_state(pathfinder, planner, current, arena_cell_index(pathfinder->arena, nx, ny) * 4 + heading, pathfinder->forwardCost, goalX, goalY))
+        {
+            return 0;
+        }
+    }
+
+    return 0;
+}
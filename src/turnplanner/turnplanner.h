@@ -0,0 +1,23 @@
+#ifndef __TURNPLANNER_H__
+#define __TURNPLANNER_H__
+
+#include "../pathfinder/pathfinder.h"
+
+// Search workspace over (cell, heading) states, state = cell * 4 + heading where heading uses the
+// robot's encoding (0 up, 1 right, 2 down, 3 left). Buffers follow the same generation scheme as pathfinder_t.
+typedef struct turn_planner_t {
+    uint32_t stateCount;
+    uint32_t generation;
+    uint32_t *g;
+    uint32_t *parent;
+    uint32_t *slot;
+    uint32_t *stamp;
+    priority_queue_t *openList;
+} turn_planner_t;
+
+turn_planner_t *create_turn_planner(uint32_t cellCount, priority_queue_type_t queueType);
+void dispose_turn_planner(turn_planner_t *planner);
+uint32_t turn_max_action_cost(pathfinder_t *pathfinder);
+node_t *turn_aware_search(pathfinder_t *pathfinder, uint32_t startX, uint32_t startY, uint8_t startHeading, uint32_t goalX, uint32_t goalY);
+
+#endif